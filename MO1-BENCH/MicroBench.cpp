@@ -0,0 +1,416 @@
+// Microbenchmarks for the emulator's hot paths.
+//
+// Each result is printed as one JSON object per line so runs can be saved
+// and diffed to catch regressions:
+//
+//   microbench [--filter <substring>] [--large] [--out <file>]
+//
+// --large adds the 1M-process process table run.
+
+#include "Config.h"
+#include "LogWriter.h"
+#include "ProcessManager.h"
+#include "Scheduler.h"
+#include "Screen.h"
+#include "Random.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    std::string filter;
+    std::string outPath;
+    bool large = false;
+};
+
+Options options;
+std::ostream* out = &std::cout;
+
+// Screens under test are named after this temp path, so the interpreter
+// benches' PRINT output (about 100k lines a run) stays out of the working
+// directory; main() removes the file when done
+std::string benchScreenName() {
+#ifdef _WIN32
+    const char* dir = std::getenv("TEMP");
+    const char separator = '\\';
+#else
+    const char* dir = std::getenv("TMPDIR");
+    if (!dir || !*dir) dir = "/tmp";
+    const char separator = '/';
+#endif
+    std::string path = dir && *dir ? std::string(dir) + separator : std::string();
+    return path + "mo1-microbench";
+}
+
+const std::string screenName = benchScreenName();
+
+bool selected(const std::string& name) {
+    return options.filter.empty() || name.find(options.filter) != std::string::npos;
+}
+
+void report(const std::string& name, const std::string& params, long long ops, Clock::duration elapsed) {
+    double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    double nsPerOp = ops > 0 ? ns / ops : 0.0;
+    double opsPerSec = ns > 0 ? ops * 1e9 / ns : 0.0;
+
+    *out << std::fixed << std::setprecision(2)
+        << "{\"name\": \"" << name << "\", \"params\": {" << params << "}"
+        << ", \"ops\": " << ops
+        << ", \"ns_per_op\": " << nsPerOp
+        << ", \"ops_per_sec\": " << opsPerSec << "}" << std::endl;
+}
+
+Instruction makeInstruction(InstructionType type) {
+    Instruction instr;
+    instr.type = type;
+    switch (type) {
+    case InstructionType::PRINT:    instr.args = { "Hello from microbench" }; break;
+    case InstructionType::DECLARE:  instr.args = { "x", "7" }; break;
+    case InstructionType::ADD:      instr.args = { "x", "x", "y" }; break;
+    case InstructionType::SUBTRACT: instr.args = { "y", "x", "3" }; break;
+    case InstructionType::SLEEP:    instr.args = { "1" }; break;
+    default: break;
+    }
+    return instr;
+}
+
+// Screen::executeNextInstruction, one program per instruction type
+void benchInterpreter() {
+    const struct { InstructionType type; const char* name; } kinds[] = {
+        { InstructionType::PRINT, "PRINT" },
+        { InstructionType::DECLARE, "DECLARE" },
+        { InstructionType::ADD, "ADD" },
+        { InstructionType::SUBTRACT, "SUBTRACT" },
+        { InstructionType::SLEEP, "SLEEP" },
+    };
+    const int programLength = 100000;
+
+    for (const auto& kind : kinds) {
+        std::string name = std::string("interpreter/") + kind.name;
+        if (!selected(name)) continue;
+
+        std::vector<Instruction> program(programLength, makeInstruction(kind.type));
+        Screen screen;
+        screen.setName(screenName);
+        screen.setInstructions(program);
+        screen.setCoreAssigned(0);
+
+        auto start = Clock::now();
+        for (int i = 0; i < programLength; ++i) {
+            screen.executeNextInstruction();
+            screen.takeSleepRequest();
+        }
+        report(name, "\"instructions\": " + std::to_string(programLength), programLength, Clock::now() - start);
+    }
+
+    // One ADD inside a 100000-iteration FOR: three code slots, loop stack
+    // bookkeeping on every iteration
+    std::string name = "interpreter/FOR";
+    if (selected(name)) {
+        Instruction loop;
+        loop.type = InstructionType::FOR;
+        loop.args = { std::to_string(programLength) };
+        loop.body = { makeInstruction(InstructionType::ADD) };
+
+        Screen screen;
+        screen.setName(screenName);
+        screen.setInstructions({ loop });
+        screen.setCoreAssigned(0);
+
+        auto start = Clock::now();
+        for (int i = 0; i < programLength; ++i) {
+            screen.executeNextInstruction();
+        }
+        report(name, "\"instructions\": " + std::to_string(programLength), programLength, Clock::now() - start);
+    }
+
+    // The rr worker's view of an ADD program: per-instruction calls with
+    // their status checks, against one runSlice per quantum
+    const int quantum = 100;
+    name = "interpreter/per-instruction";
+    if (selected(name)) {
+        Screen screen;
+        screen.setName(screenName);
+        screen.setInstructions(std::vector<Instruction>(programLength, makeInstruction(InstructionType::ADD)));
+        screen.setCoreAssigned(0);
+
+        auto start = Clock::now();
+        while (!screen.isFinished()) {
+            screen.executeNextInstruction();
+            if (screen.hasError()) break;
+            screen.takeSleepRequest();
+        }
+        report(name, "\"instructions\": " + std::to_string(programLength), programLength, Clock::now() - start);
+    }
+
+    name = "interpreter/slice";
+    if (selected(name)) {
+        Screen screen;
+        screen.setName(screenName);
+        screen.setInstructions(std::vector<Instruction>(programLength, makeInstruction(InstructionType::ADD)));
+        screen.setCoreAssigned(0);
+
+        auto start = Clock::now();
+        while (!screen.runSlice(quantum).finished) {
+        }
+        report(name, "\"instructions\": " + std::to_string(programLength) + ", \"quantum\": " + std::to_string(quantum),
+            programLength, Clock::now() - start);
+    }
+    LogWriter::flush();
+}
+
+// addProcess from producer threads, dequeued and run by the worker cores
+void benchReadyQueue() {
+    const int counts[][2] = { { 1, 1 }, { 1, 4 }, { 4, 4 }, { 8, 8 } };
+    const int perProducer = 20000;
+
+    for (const auto& pc : counts) {
+        int producers = pc[0], consumers = pc[1];
+        std::string name = "scheduler/addProcess+dequeue";
+        std::string params = "\"producers\": " + std::to_string(producers) + ", \"consumers\": " + std::to_string(consumers);
+        if (!selected(name)) continue;
+
+        Config cfg;
+        cfg.numCpu = consumers;
+        cfg.schedulerType = "rr";
+        cfg.quantum = 1;
+        cfg.delayPerExec = 0;
+
+        std::vector<Instruction> program(1, makeInstruction(InstructionType::DECLARE));
+        std::vector<std::shared_ptr<Screen>> screens;
+        for (int i = 0; i < producers * perProducer; ++i) {
+            auto screen = std::make_shared<Screen>();
+            screen->setInstructions(program);
+            screens.push_back(screen);
+        }
+
+        Scheduler scheduler(cfg);
+        scheduler.start();
+
+        long long total = static_cast<long long>(producers) * perProducer;
+        auto start = Clock::now();
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; ++p) {
+            threads.emplace_back([&, p] {
+                for (int i = 0; i < perProducer; ++i) {
+                    scheduler.addProcess(screens[p * perProducer + i]);
+                }
+            });
+        }
+        for (auto& t : threads) t.join();
+
+        while (true) {
+            long long dispatched = 0;
+            for (const auto& core : scheduler.snapshotCores()) dispatched += core.dispatches;
+            if (dispatched >= total) break;
+            std::this_thread::yield();
+        }
+        report(name, params, total, Clock::now() - start);
+        scheduler.finish();
+    }
+}
+
+// registerProcess / getProcess by name and PID / listScreens at increasing table sizes
+void benchProcessTable() {
+    std::vector<int> sizes = { 10000, 100000 };
+    if (options.large) sizes.push_back(1000000);
+
+    for (int size : sizes) {
+        std::string params = "\"processes\": " + std::to_string(size);
+        ProcessManager::reset();
+
+        std::vector<std::shared_ptr<Screen>> screens;
+        screens.reserve(size);
+        for (int i = 0; i < size; ++i) {
+            auto screen = std::make_shared<Screen>();
+            screen->setName("bench" + std::to_string(i));
+            screen->setProcessId(i + 1);
+            screens.push_back(screen);
+        }
+
+        if (selected("process-table/registerProcess")) {
+            auto start = Clock::now();
+            for (const auto& screen : screens) ProcessManager::registerProcess(screen);
+            report("process-table/registerProcess", params, size, Clock::now() - start);
+        }
+        else {
+            for (const auto& screen : screens) ProcessManager::registerProcess(screen);
+        }
+
+        if (selected("process-table/getProcess")) {
+            const int lookups = 200000;
+            auto start = Clock::now();
+            size_t found = 0;
+            for (int i = 0; i < lookups; ++i) {
+                found += ProcessManager::getProcess("bench" + std::to_string((i * 7919) % size)) != nullptr;
+            }
+            report("process-table/getProcess", params, lookups, Clock::now() - start);
+            if (found != static_cast<size_t>(lookups)) std::cerr << "getProcess missed entries\n";
+        }
+
+        if (selected("process-table/getProcessById")) {
+            const int lookups = 200000;
+            auto start = Clock::now();
+            size_t found = 0;
+            for (int i = 0; i < lookups; ++i) {
+                found += ProcessManager::getProcess((i * 7919) % size + 1) != nullptr;
+            }
+            report("process-table/getProcessById", params, lookups, Clock::now() - start);
+            if (found != static_cast<size_t>(lookups)) std::cerr << "getProcess by PID missed entries\n";
+        }
+
+        if (selected("process-table/listScreens")) {
+            Config cfg;
+            std::ostringstream sink;
+            std::streambuf* saved = std::cout.rdbuf(sink.rdbuf());
+            auto start = Clock::now();
+            ProcessManager::listScreens(cfg);
+            auto elapsed = Clock::now() - start;
+            std::cout.rdbuf(saved);
+            report("process-table/listScreens", params, 1, elapsed);
+        }
+    }
+    ProcessManager::reset();
+}
+
+// generateDummyInstructions at max-ins 2000
+void benchGenerator() {
+    std::string name = "generator/generateDummyInstructions";
+    if (!selected(name)) return;
+
+    Config cfg;
+    cfg.minIns = 2000;
+    cfg.maxIns = 2000;
+    const int programs = 500;
+
+    Screen screen;
+    screen.setName(screenName);
+    auto start = Clock::now();
+    for (int i = 0; i < programs; ++i) {
+        screen.generateDummyInstructions(cfg);
+    }
+    report(name, "\"max_ins\": 2000", programs, Clock::now() - start);
+}
+
+// rand() against the per-thread generator, with 1 and 4 threads drawing
+void benchRandom() {
+    const int draws = 1000000;
+
+    for (const char* kind : { "rand", "xoshiro" }) {
+        for (int threads : { 1, 4 }) {
+            std::string name = std::string("random/") + kind;
+            if (!selected(name)) continue;
+
+            bool useRand = std::string(kind) == "rand";
+            std::atomic<unsigned long long> sink{ 0 };
+            std::vector<std::thread> workers;
+
+            auto start = Clock::now();
+            for (int t = 0; t < threads; ++t) {
+                workers.emplace_back([&sink, useRand, draws]() {
+                    unsigned long long sum = 0;
+                    if (useRand) {
+                        for (int i = 0; i < draws; ++i) sum += static_cast<unsigned>(rand() % 6);
+                    }
+                    else {
+                        Xoshiro256& rng = Random::local();
+                        for (int i = 0; i < draws; ++i) sum += rng.below(6);
+                    }
+                    sink.fetch_add(sum);
+                });
+            }
+            for (auto& worker : workers) worker.join();
+            report(name, "\"threads\": " + std::to_string(threads), static_cast<long long>(draws) * threads,
+                Clock::now() - start);
+        }
+    }
+}
+
+// Bytes per queued process for materialized vs. procedural programs
+void benchProgramMemory() {
+    std::string name = "generator/memory";
+    if (!selected(name)) return;
+
+    Config cfg;
+    cfg.minIns = 1000;
+    cfg.maxIns = 2000;
+    const int processes = 5000;
+
+    for (const char* mode : { "materialized", "procedural" }) {
+        bool procedural = std::string(mode) == "procedural";
+        std::vector<std::unique_ptr<Screen>> screens;
+        screens.reserve(processes);
+
+        auto start = Clock::now();
+        for (int i = 0; i < processes; ++i) {
+            std::unique_ptr<Screen> screen(new Screen());
+            screen->setName("process" + std::to_string(i + 1));
+            int count = cfg.minIns + i % (cfg.maxIns - cfg.minIns + 1);
+            if (procedural) screen->generateProceduralInstructions(0x9E3779B97F4A7C15ULL * (i + 1), count);
+            else {
+                Xoshiro256 rng = Random::forProcess(cfg.seed, i + 1);
+                screen->generateDummyInstructions(cfg, count, rng);
+            }
+            screens.push_back(std::move(screen));
+        }
+        auto elapsed = Clock::now() - start;
+
+        size_t bytes = 0;
+        for (const auto& screen : screens) bytes += screen->memoryFootprint();
+
+        std::string params = "\"mode\": \"" + std::string(mode) + "\", \"processes\": " + std::to_string(processes)
+            + ", \"bytes_per_process\": " + std::to_string(bytes / processes);
+        report(name, params, processes, elapsed);
+    }
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--filter" && i + 1 < argc) options.filter = argv[++i];
+        else if (arg == "--out" && i + 1 < argc) options.outPath = argv[++i];
+        else if (arg == "--large") options.large = true;
+        else {
+            std::cerr << "Unknown option: " << arg << "\n";
+            return 2;
+        }
+    }
+
+    std::ofstream file;
+    if (!options.outPath.empty()) {
+        file.open(options.outPath);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open " << options.outPath << "\n";
+            return 1;
+        }
+        out = &file;
+    }
+
+    LogWriter::start();
+    benchInterpreter();
+    benchReadyQueue();
+    benchProcessTable();
+    benchGenerator();
+    benchRandom();
+    benchProgramMemory();
+    LogWriter::shutdown();
+    std::remove((screenName + ".log").c_str());
+    return 0;
+}
@@ -0,0 +1,45 @@
+#include "ArrivalProcess.h"
+#include <algorithm>
+#include <stdexcept>
+
+ArrivalProcess::ArrivalProcess(Mode mode_, double meanGap, int burstSize_, unsigned int seed)
+    : mode(mode_),
+    mean(std::max(meanGap, 0.0)),
+    burstSize(std::max(burstSize_, 1)),
+    burstLeft(0),
+    gen(seed),
+    exponential(mean > 0.0 ? 1.0 / mean : 1.0)
+{
+}
+
+double ArrivalProcess::nextGap() {
+    switch (mode) {
+    case Mode::POISSON:
+        return mean > 0.0 ? exponential(gen) : 0.0;
+    case Mode::BURST:
+        if (burstLeft > 0) {
+            --burstLeft;
+            return 0.0;
+        }
+        burstLeft = burstSize - 1;
+        return mean * burstSize;
+    case Mode::FIXED:
+    default:
+        return mean;
+    }
+}
+
+ArrivalProcess::Mode ArrivalProcess::parseMode(const std::string& name) {
+    if (name == "fixed") return Mode::FIXED;
+    if (name == "poisson") return Mode::POISSON;
+    if (name == "burst") return Mode::BURST;
+    throw std::runtime_error("Invalid arrival-mode value.");
+}
+
+const char* ArrivalProcess::modeName(Mode mode) {
+    switch (mode) {
+    case Mode::POISSON: return "poisson";
+    case Mode::BURST:   return "burst";
+    default:            return "fixed";
+    }
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <random>
+#include <string>
+
+// Inter-arrival gaps for the dummy process generator, in scheduler clock
+// units (milliseconds in real mode, ticks in virtual mode).
+//
+//   fixed   - one process every mean gap
+//   poisson - exponentially distributed gaps with the given mean
+//   burst   - burstSize processes at once, bursts spaced so the average
+//             rate still matches the mean gap
+class ArrivalProcess {
+public:
+    enum class Mode { FIXED, POISSON, BURST };
+
+    ArrivalProcess(Mode mode, double meanGap, int burstSize, unsigned int seed);
+
+    // Gap between the previous arrival and the next one; zero within a burst
+    double nextGap();
+
+    double meanGap() const { return mean; }
+
+    static Mode parseMode(const std::string& name);
+    static const char* modeName(Mode mode);
+
+private:
+    Mode mode;
+    double mean;
+    int burstSize;
+    int burstLeft;
+    std::mt19937 gen;
+    std::exponential_distribution<double> exponential;
+};
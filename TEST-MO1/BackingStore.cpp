@@ -0,0 +1,105 @@
+#include "BackingStore.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+BackingStore::~BackingStore() {
+    close();
+}
+
+bool BackingStore::open(const std::string& path, size_t pageSize_) {
+    close();
+    pageSize = pageSize_;
+
+#ifdef _WIN32
+    file.open(path, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) return false;
+#else
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return false;
+#endif
+    return grow(64);
+}
+
+void BackingStore::close() {
+#ifdef _WIN32
+    if (file.is_open()) file.close();
+#else
+    if (base) munmap(base, capacity * pageSize);
+    if (fd >= 0) ::close(fd);
+    base = nullptr;
+    fd = -1;
+#endif
+    capacity = next = used = 0;
+    freeSlots.clear();
+}
+
+// The file is extended sparsely, so unused capacity costs no disk space.
+// The old mapping is dropped only once the larger one exists, so a failed
+// grow leaves every page handed out so far readable.
+bool BackingStore::grow(size_t minSlots) {
+    size_t newCapacity = std::max(minSlots, capacity * 2);
+
+#ifdef _WIN32
+    capacity = newCapacity;
+    return true;
+#else
+    if (ftruncate(fd, static_cast<off_t>(newCapacity * pageSize)) != 0) return false;
+
+    void* mapped = mmap(nullptr, newCapacity * pageSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapped == MAP_FAILED) return false;
+
+    if (base) munmap(base, capacity * pageSize);
+    base = static_cast<uint8_t*>(mapped);
+    capacity = newCapacity;
+    return true;
+#endif
+}
+
+int64_t BackingStore::allocate() {
+    ++used;
+    if (!freeSlots.empty()) {
+        int64_t slot = freeSlots.back();
+        freeSlots.pop_back();
+        return slot;
+    }
+
+    if (next >= capacity && !grow(next + 1)) {
+        --used;
+        throw std::runtime_error("Backing store could not grow.");
+    }
+    return static_cast<int64_t>(next++);
+}
+
+void BackingStore::release(int64_t slot) {
+    --used;
+    freeSlots.push_back(slot);
+}
+
+void BackingStore::writePage(int64_t slot, const uint8_t* src) {
+#ifdef _WIN32
+    file.seekp(slot * static_cast<int64_t>(pageSize));
+    file.write(reinterpret_cast<const char*>(src), pageSize);
+#else
+    std::memcpy(base + slot * pageSize, src, pageSize);
+#endif
+}
+
+void BackingStore::readPage(int64_t slot, uint8_t* dst) {
+#ifdef _WIN32
+    file.seekg(slot * static_cast<int64_t>(pageSize));
+    file.read(reinterpret_cast<char*>(dst), pageSize);
+    if (!file) {
+        file.clear();
+        std::memset(dst, 0, pageSize);
+    }
+#else
+    std::memcpy(dst, base + slot * pageSize, pageSize);
+#endif
+}
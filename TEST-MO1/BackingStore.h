@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <fstream>
+#endif
+
+// Page-sized slots in a file that holds evicted pages. On POSIX systems the
+// file is memory-mapped and grown by doubling; Windows falls back to plain
+// file reads and writes. Not thread-safe: MemoryManager serializes access.
+class BackingStore {
+public:
+    BackingStore() = default;
+    ~BackingStore();
+
+    BackingStore(const BackingStore&) = delete;
+    BackingStore& operator=(const BackingStore&) = delete;
+
+    // Truncates any existing file
+    bool open(const std::string& path, size_t pageSize);
+    void close();
+
+    int64_t allocate();
+    void release(int64_t slot);
+
+    void writePage(int64_t slot, const uint8_t* src);
+    void readPage(int64_t slot, uint8_t* dst);
+
+    size_t slotsInUse() const { return used; }
+
+private:
+    bool grow(size_t minSlots);
+
+    size_t pageSize = 0;
+    size_t capacity = 0;   // in slots
+    size_t next = 0;       // slots handed out so far
+    size_t used = 0;
+    std::vector<int64_t> freeSlots;
+
+#ifdef _WIN32
+    std::fstream file;
+#else
+    int fd = -1;
+    uint8_t* base = nullptr;
+#endif
+};
@@ -0,0 +1,318 @@
+#include "Benchmark.h"
+#include "Config.h"
+#include "LogWriter.h"
+#include "MemoryManager.h"
+#include "ProcessManager.h"
+#include "Scheduler.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Options {
+    std::string configPath = "config.txt";
+    std::string jsonPath = "bench-results.json";
+    int processes = 100;
+    double durationSeconds = 0.0;   // 0 = run until drained
+};
+
+struct Percentiles {
+    double p50 = 0, p95 = 0, p99 = 0, mean = 0;
+    size_t count = 0;
+};
+
+Percentiles summarize(std::vector<double> values) {
+    Percentiles result;
+    result.count = values.size();
+    if (values.empty()) return result;
+
+    std::sort(values.begin(), values.end());
+    auto rank = [&values](double p) {
+        size_t index = static_cast<size_t>(p * values.size());
+        return values[std::min(index, values.size() - 1)];
+    };
+
+    double sum = 0;
+    for (double v : values) sum += v;
+
+    result.p50 = rank(0.50);
+    result.p95 = rank(0.95);
+    result.p99 = rank(0.99);
+    result.mean = sum / values.size();
+    return result;
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--config" && hasValue) options.configPath = argv[++i];
+        else if (arg == "--json" && hasValue) options.jsonPath = argv[++i];
+        else if (arg == "--processes" && hasValue) options.processes = std::max(1, std::stoi(argv[++i]));
+        else if (arg == "--duration" && hasValue) options.durationSeconds = std::stod(argv[++i]);
+        else if (arg == "--until-drained") options.durationSeconds = 0.0;
+        else {
+            std::cerr << "Unknown benchmark option: " << arg << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+bool drained(const Scheduler& scheduler, int target) {
+    if (scheduler.getDummyCount() < target) return false;
+    bool allFinished = true;
+    ProcessManager::forEachProcess([&allFinished](const std::shared_ptr<Screen>& proc) {
+        if (allFinished && !proc->isFinished()) allFinished = false;
+    });
+    return allFinished;
+}
+
+void writeLatencyJson(std::ostream& out, const char* name, const Percentiles& p) {
+    out << "    \"" << name << "\": { \"count\": " << p.count
+        << ", \"p50\": " << p.p50 << ", \"p95\": " << p.p95
+        << ", \"p99\": " << p.p99 << ", \"mean\": " << p.mean << " }";
+}
+
+}
+
+int Benchmark::run(int argc, char* argv[]) {
+    Options options;
+    try {
+        if (!parseOptions(argc, argv, options)) return 2;
+        config.loadConfig(options.configPath);
+        MemoryManager::configure(config);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Benchmark setup failed: " << e.what() << "\n";
+        return 2;
+    }
+
+    LogWriter::start();
+
+    uint64_t elapsed = 0;
+    std::vector<Scheduler::CoreSnapshot> cores;
+    bool virtualClock = false;
+    Scheduler::ArrivalStats arrivals;
+    Scheduler::FeedbackStats mlfq;
+    int finalQuantum = config.quantum;
+    std::vector<QuantumTuner::Decision> quantumHistory;
+    Scheduler::IdleStats idle;
+    {
+        Scheduler scheduler(config);
+        scheduler.setDummyLimit(options.processes);
+        scheduler.start();
+        scheduler.startDummyGeneration();
+
+        auto wallStart = std::chrono::steady_clock::now();
+        while (true) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+            if (options.durationSeconds > 0.0) {
+                double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+                if (wall >= options.durationSeconds) break;
+            }
+            else if (drained(scheduler, options.processes)) {
+                break;
+            }
+        }
+
+        scheduler.stopDummyGeneration();
+        scheduler.finish();
+        elapsed = scheduler.clockNow();
+        cores = scheduler.snapshotCores();
+        virtualClock = scheduler.usesVirtualClock();
+        arrivals = scheduler.arrivalStats();
+        mlfq = scheduler.feedbackStats();
+        finalQuantum = scheduler.currentQuantum();
+        quantumHistory = scheduler.quantumHistory();
+        idle = scheduler.idleStats();
+    }
+
+    LogWriter::shutdown();
+    MemoryManager::Summary memory = MemoryManager::summary();
+    MemoryManager::shutdown();
+
+    // Real mode reports milliseconds, virtual mode reports ticks
+    const double unitScale = virtualClock ? 1.0 : 1e-6;
+    const char* unit = virtualClock ? "ticks" : "ms";
+
+    std::vector<double> waiting, response, turnaround, cpuTime;
+    int finishedCount = 0;
+    auto processes = ProcessManager::getAllProcesses();
+    for (const auto& proc : processes) {
+        ProcessTimes t = proc->getTimes();
+        if (t.started) response.push_back((t.firstRun - t.arrival) * unitScale);
+        if (t.completed) {
+            ++finishedCount;
+            waiting.push_back(t.readyWait * unitScale);
+            turnaround.push_back((t.finish - t.arrival) * unitScale);
+            cpuTime.push_back(t.cpuTime * unitScale);
+        }
+    }
+
+    Percentiles waitingStats = summarize(waiting);
+    Percentiles responseStats = summarize(response);
+    Percentiles turnaroundStats = summarize(turnaround);
+    Percentiles cpuTimeStats = summarize(cpuTime);
+
+    long long totalInstructions = 0, contextSwitches = 0, migrations = 0;
+    for (const auto& core : cores) {
+        totalInstructions += core.instructions;
+        contextSwitches += core.dispatches;
+        migrations += core.migrations;
+    }
+
+    double elapsedUnits = elapsed * unitScale;
+    double elapsedSeconds = virtualClock ? elapsedUnits : elapsedUnits / 1000.0;
+    double throughput = elapsedSeconds > 0 ? totalInstructions / elapsedSeconds : 0.0;
+    const char* rateUnit = virtualClock ? "instructions/tick" : "instructions/sec";
+    const char* arrivalUnit = virtualClock ? "processes/tick" : "processes/sec";
+
+    std::cout << std::fixed << std::setprecision(2)
+        << "Benchmark Results\n"
+        << "----------------------------------------\n"
+        << "Scheduler:        " << config.schedulerType << " (quantum " << config.quantum
+        << (config.quantumMode == "adaptive" ? ", adaptive, final " + std::to_string(finalQuantum) : "") << ")\n"
+        << "Cores:            " << config.numCpu << "\n"
+        << "Clock:            " << config.clockMode << "\n"
+        << "Processes:        " << processes.size() << " created, " << finishedCount << " finished\n"
+        << "Elapsed:          " << elapsedUnits << " " << unit << "\n"
+        << "Instructions:     " << totalInstructions << "\n"
+        << "Throughput:       " << throughput << " " << rateUnit << "\n"
+        << "Context Switches: " << contextSwitches << "\n"
+        << "Migrations:       " << migrations << "\n"
+        << "Arrivals:         " << arrivals.mode << ", requested " << arrivals.requestedRate
+        << ", achieved " << arrivals.achievedRate << " " << arrivalUnit << "\n";
+    if (memory.enabled) {
+        std::cout << "Paging:           " << memory.policy << ", " << memory.totalFrames << " frames of "
+            << memory.frameSize << " bytes, " << memory.pageIns << " in, " << memory.pageOuts << " out\n";
+    }
+    std::cout << "\nCore Utilization:\n";
+    for (size_t i = 0; i < cores.size(); ++i) {
+        double util = elapsed > 0 ? 100.0 * cores[i].busyTime / elapsed : 0.0;
+        std::cout << "  Core " << std::setw(3) << std::left << i << std::right
+            << std::setw(8) << util << "%   " << cores[i].instructions << " instructions, "
+            << cores[i].migrations << " migrations in\n";
+    }
+
+    std::cout << "\n" << std::setw(12) << std::left << ("Latency " + std::string(unit)) << std::right
+        << std::setw(12) << "p50" << std::setw(12) << "p95"
+        << std::setw(12) << "p99" << std::setw(12) << "mean" << "\n";
+    auto printRow = [](const char* name, const Percentiles& p) {
+        std::cout << std::setw(12) << std::left << name << std::right
+            << std::setw(12) << p.p50 << std::setw(12) << p.p95
+            << std::setw(12) << p.p99 << std::setw(12) << p.mean << "\n";
+    };
+    printRow("Waiting", waitingStats);
+    printRow("Response", responseStats);
+    printRow("Turnaround", turnaroundStats);
+    printRow("CPU Time", cpuTimeStats);
+
+    // Enqueue to dispatch, from per-core histograms (bucket upper bounds)
+    if (!virtualClock) {
+        std::cout << "\nIdle Strategy:    " << idle.strategy << ", " << idle.parks << " parks, "
+            << idle.wakeups << " wakeups, " << idle.spinHits << " spin hits\n"
+            << "Dispatch Latency: p50 " << LatencyHistogram::format(idle.dispatchLatency.percentile(0.5), false)
+            << ", p99 " << LatencyHistogram::format(idle.dispatchLatency.percentile(0.99), false)
+            << "; after idle p50 " << LatencyHistogram::format(idle.wakeLatency.percentile(0.5), false)
+            << ", p99 " << LatencyHistogram::format(idle.wakeLatency.percentile(0.99), false) << "\n";
+    }
+
+    if (!mlfq.levels.empty()) {
+        std::cout << "\nMLFQ Levels:\n"
+            << "  Level  Quantum  Dispatches  Avg Wait (" << unit << ")\n";
+        for (size_t i = 0; i < mlfq.levels.size(); ++i) {
+            const FeedbackQueue::LevelStats& level = mlfq.levels[i];
+            double avgWait = level.dispatches ? level.totalWait * unitScale / level.dispatches : 0.0;
+            std::cout << "  " << std::setw(5) << i << std::setw(9) << level.quantum
+                << std::setw(12) << level.dispatches << std::setw(12) << avgWait << "\n";
+        }
+        std::cout << "  Demotions " << mlfq.demotions << ", promotions " << mlfq.promotions
+            << ", aging boosts " << mlfq.boosts << "\n";
+    }
+
+    std::ofstream json(options.jsonPath);
+    if (!json.is_open()) {
+        std::cerr << "Failed to open " << options.jsonPath << " for writing.\n";
+        return 1;
+    }
+
+    json << std::fixed << std::setprecision(3)
+        << "{\n"
+        << "  \"scheduler\": \"" << config.schedulerType << "\",\n"
+        << "  \"quantum\": " << config.quantum << ",\n"
+        << "  \"quantum_mode\": \"" << config.quantumMode << "\",\n"
+        << "  \"final_quantum\": " << finalQuantum << ",\n"
+        << "  \"cores\": " << config.numCpu << ",\n"
+        << "  \"clock\": \"" << config.clockMode << "\",\n"
+        << "  \"unit\": \"" << unit << "\",\n"
+        << "  \"processes_created\": " << processes.size() << ",\n"
+        << "  \"processes_finished\": " << finishedCount << ",\n"
+        << "  \"elapsed\": " << elapsedUnits << ",\n"
+        << "  \"instructions\": " << totalInstructions << ",\n"
+        << "  \"throughput\": " << throughput << ",\n"
+        << "  \"context_switches\": " << contextSwitches << ",\n"
+        << "  \"migrations\": " << migrations << ",\n"
+        << "  \"arrivals\": { \"mode\": \"" << arrivals.mode << "\", \"requested_rate\": " << arrivals.requestedRate
+        << ", \"achieved_rate\": " << arrivals.achievedRate << ", \"batches\": " << arrivals.batches << " },\n";
+    if (memory.enabled) {
+        json << "  \"paging\": { \"policy\": \"" << memory.policy << "\", \"frames\": " << memory.totalFrames
+            << ", \"frame_size\": " << memory.frameSize << ", \"page_ins\": " << memory.pageIns
+            << ", \"page_outs\": " << memory.pageOuts << " },\n";
+    }
+    json
+        << "  \"core_utilization\": [";
+    for (size_t i = 0; i < cores.size(); ++i) {
+        double util = elapsed > 0 ? 100.0 * cores[i].busyTime / elapsed : 0.0;
+        json << (i ? ", " : "") << util;
+    }
+    json << "],\n  \"latency\": {\n";
+    writeLatencyJson(json, "waiting", waitingStats);
+    json << ",\n";
+    writeLatencyJson(json, "response", responseStats);
+    json << ",\n";
+    writeLatencyJson(json, "turnaround", turnaroundStats);
+    json << ",\n";
+    writeLatencyJson(json, "cpu_time", cpuTimeStats);
+    json << "\n  }";
+    if (!virtualClock) {
+        json << ",\n  \"idle\": { \"strategy\": \"" << idle.strategy << "\", \"parks\": " << idle.parks
+            << ", \"wakeups\": " << idle.wakeups << ", \"spin_hits\": " << idle.spinHits
+            << ", \"dispatch_p50\": " << idle.dispatchLatency.percentile(0.5) * unitScale
+            << ", \"dispatch_p99\": " << idle.dispatchLatency.percentile(0.99) * unitScale
+            << ", \"wake_p50\": " << idle.wakeLatency.percentile(0.5) * unitScale
+            << ", \"wake_p99\": " << idle.wakeLatency.percentile(0.99) * unitScale << " }";
+    }
+    if (!mlfq.levels.empty()) {
+        json << ",\n  \"mlfq\": { \"demotions\": " << mlfq.demotions << ", \"promotions\": " << mlfq.promotions
+            << ", \"boosts\": " << mlfq.boosts << ", \"levels\": [";
+        for (size_t i = 0; i < mlfq.levels.size(); ++i) {
+            const FeedbackQueue::LevelStats& level = mlfq.levels[i];
+            double avgWait = level.dispatches ? level.totalWait * unitScale / level.dispatches : 0.0;
+            json << (i ? ", " : "") << "{ \"quantum\": " << level.quantum << ", \"dispatches\": " << level.dispatches
+                << ", \"avg_wait\": " << avgWait << ", \"max_wait\": " << level.maxWait * unitScale << " }";
+        }
+        json << "] }";
+    }
+    if (!quantumHistory.empty()) {
+        json << ",\n  \"quantum_history\": [";
+        for (size_t i = 0; i < quantumHistory.size(); ++i) {
+            json << (i ? ", " : "") << "{ \"time\": " << quantumHistory[i].time * unitScale
+                << ", \"quantum\": " << quantumHistory[i].quantum << " }";
+        }
+        json << "]";
+    }
+    json << "\n}\n";
+
+    std::cout << "\nJSON results saved to " << options.jsonPath << "\n";
+    return 0;
+}
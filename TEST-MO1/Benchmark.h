@@ -0,0 +1,11 @@
+#pragma once
+
+// Headless benchmark mode: runs the scheduler without the interactive CLI
+// and reports throughput, utilization and latency percentiles.
+//
+//   csopesy --bench [--config <file>] [--processes <n>]
+//                   [--duration <seconds> | --until-drained] [--json <file>]
+class Benchmark {
+public:
+    static int run(int argc, char* argv[]);
+};
@@ -0,0 +1,336 @@
+#include "Bytecode.h"
+#include "Screen.h"
+#include <algorithm>
+#include <cctype>
+#include <functional>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+
+class ProgramBuilder {
+public:
+    explicit ProgramBuilder(Program& p) : program(p) {}
+
+    uint16_t slot(const std::string& name) {
+        auto it = slots.find(name);
+        if (it != slots.end()) return it->second;
+
+        if (program.slotNames.size() > UINT16_MAX) {
+            throw std::runtime_error("too many variables");
+        }
+        uint16_t index = static_cast<uint16_t>(program.slotNames.size());
+        program.slotNames.push_back(name);
+        slots.emplace(name, index);
+        return index;
+    }
+
+    int32_t string(const std::string& text) {
+        auto it = strings.find(text);
+        if (it != strings.end()) return it->second;
+
+        int32_t index = static_cast<int32_t>(program.strings.size());
+        program.strings.push_back(text);
+        strings.emplace(text, index);
+        return index;
+    }
+
+    void error(const std::string& message) {
+        CompiledInstruction ci;
+        ci.op = OpCode::ERROR;
+        ci.a = string(message);
+        program.code.push_back(ci);
+    }
+
+private:
+    Program& program;
+    std::unordered_map<std::string, uint16_t> slots;
+    std::unordered_map<std::string, int32_t> strings;
+};
+
+}
+
+bool BytecodeCompiler::isNumber(const std::string& s) {
+    if (s.empty()) return false;
+    for (char c : s)
+        if (!isdigit(static_cast<unsigned char>(c)) && c != '-') return false;
+    return true;
+}
+
+uint64_t BytecodeCompiler::expandedLength(const std::vector<Instruction>& instructions) {
+    uint64_t total = 0;
+    for (const Instruction& instr : instructions) {
+        if (instr.type != InstructionType::FOR) {
+            ++total;
+            continue;
+        }
+
+        int repeats = 0;
+        try {
+            repeats = instr.args.empty() ? 0 : std::stoi(instr.args[0]);
+        }
+        catch (...) {
+            ++total;   // compiles to an ERROR op
+            continue;
+        }
+        if (repeats > 0) total += static_cast<uint64_t>(repeats) * expandedLength(instr.body);
+    }
+    return total;
+}
+
+Program BytecodeCompiler::compile(const std::vector<Instruction>& instructions) {
+    Program program;
+    ProgramBuilder builder(program);
+    program.code.reserve(instructions.size());
+
+    std::function<void(const std::vector<Instruction>&)> compileList = [&](const std::vector<Instruction>& list) {
+        for (const Instruction& instr : list) {
+            CompiledInstruction ci;
+
+            switch (instr.type) {
+            case InstructionType::PRINT:
+                if (!instr.args.empty()) {
+                    ci.op = OpCode::PRINT;
+                    ci.a = builder.string(instr.args[0]);
+                }
+                break;
+
+            case InstructionType::SLEEP:
+                if (!instr.args.empty()) {
+                    try {
+                        ci.op = OpCode::SLEEP;
+                        ci.flags = OPERAND_A_IMM;
+                        ci.a = std::stoi(instr.args[0]);
+                    }
+                    catch (...) {
+                        builder.error("[ERROR] Invalid sleep duration: " + instr.args[0]);
+                        continue;
+                    }
+                }
+                break;
+
+            case InstructionType::DECLARE:
+                if (instr.args.size() == 2) {
+                    try {
+                        ci.op = OpCode::DECLARE;
+                        ci.flags = OPERAND_A_IMM;
+                        ci.a = std::stoi(instr.args[1]);
+                        ci.dst = builder.slot(instr.args[0]);
+                    }
+                    catch (...) {
+                        builder.error("[ERROR] Invalid DECLARE value: " + instr.args[1]);
+                        continue;
+                    }
+                }
+                break;
+
+            case InstructionType::ADD:
+            case InstructionType::SUBTRACT:
+                if (instr.args.size() == 3) {
+                    const char* opName = instr.type == InstructionType::ADD ? "ADD" : "SUBTRACT";
+                    try {
+                        ci.op = instr.type == InstructionType::ADD ? OpCode::ADD : OpCode::SUBTRACT;
+                        ci.dst = builder.slot(instr.args[0]);
+
+                        if (isNumber(instr.args[1])) {
+                            ci.flags |= OPERAND_A_IMM;
+                            ci.a = std::stoi(instr.args[1]);
+                        }
+                        else {
+                            ci.a = builder.slot(instr.args[1]);
+                        }
+
+                        if (isNumber(instr.args[2])) {
+                            ci.flags |= OPERAND_B_IMM;
+                            ci.b = std::stoi(instr.args[2]);
+                        }
+                        else {
+                            ci.b = builder.slot(instr.args[2]);
+                        }
+                    }
+                    catch (const std::exception& e) {
+                        builder.error(std::string("[ERROR] Invalid ") + opName + " operands: " + e.what());
+                        continue;
+                    }
+                }
+                break;
+
+            case InstructionType::FOR: {
+                // Loops with nothing to run vanish; the body is compiled once
+                // and the interpreter repeats it from its loop stack
+                int repeats = 0;
+                try {
+                    repeats = instr.args.empty() ? 0 : std::stoi(instr.args[0]);
+                }
+                catch (...) {
+                    builder.error("[ERROR] Invalid FOR repeat count: " + instr.args[0]);
+                    continue;
+                }
+                if (repeats <= 0 || expandedLength(instr.body) == 0) continue;
+
+                size_t begin = program.code.size();
+                ci.op = OpCode::FOR_BEGIN;
+                ci.flags = OPERAND_A_IMM;
+                ci.a = repeats;
+                program.code.push_back(ci);
+
+                compileList(instr.body);
+
+                CompiledInstruction end;
+                end.op = OpCode::FOR_END;
+                program.code.push_back(end);
+                program.code[begin].b = static_cast<int32_t>(program.code.size() - begin);
+                continue;
+            }
+
+            default:
+                break;
+            }
+
+            program.code.push_back(ci);
+        }
+    };
+
+    compileList(instructions);
+    program.length = static_cast<size_t>(expandedLength(instructions));
+    return program;
+}
+
+size_t Program::footprint() const {
+    size_t bytes = code.capacity() * sizeof(CompiledInstruction);
+    for (const auto& s : strings) bytes += sizeof(std::string) + (s.capacity() > 15 ? s.capacity() + 1 : 0);
+    for (const auto& s : slotNames) bytes += sizeof(std::string) + (s.capacity() > 15 ? s.capacity() + 1 : 0);
+    return bytes;
+}
+
+namespace {
+
+// Variables every generated program may touch, in slot order
+const char* const GENERATED_VARIABLES[] = { "x", "y", "z", "a", "b", "c" };
+constexpr uint16_t GENERATED_VARIABLE_COUNT = 6;
+
+uint64_t splitmix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Same instruction mix as Screen::generateDummyInstructions, already compiled
+CompiledInstruction simpleInstruction(uint64_t r) {
+    auto pick = [&r](uint64_t n) {
+        uint64_t value = r % n;
+        r /= n;
+        return value;
+    };
+
+    CompiledInstruction ci;
+    switch (pick(5)) {
+    case 0:
+        ci.op = OpCode::PRINT;
+        ci.a = 0;
+        break;
+    case 1:
+        ci.op = OpCode::DECLARE;
+        ci.flags = OPERAND_A_IMM;
+        ci.dst = static_cast<uint16_t>(pick(GENERATED_VARIABLE_COUNT));
+        ci.a = static_cast<int32_t>(pick(20)) + 1;
+        break;
+    case 2:
+    case 3:
+        ci.op = (r & 1) ? OpCode::SUBTRACT : OpCode::ADD;
+        r >>= 1;
+        ci.dst = static_cast<uint16_t>(pick(GENERATED_VARIABLE_COUNT));
+        ci.a = static_cast<int32_t>(pick(GENERATED_VARIABLE_COUNT));
+        ci.b = static_cast<int32_t>(pick(GENERATED_VARIABLE_COUNT));
+        break;
+    default:
+        ci.op = OpCode::SLEEP;
+        ci.flags = OPERAND_A_IMM;
+        ci.a = static_cast<int32_t>(pick(3)) + 1;
+        break;
+    }
+    return ci;
+}
+
+// FOR loop of 2-5 repeats whose whole body fits in `room` slots, so a loop
+// never crosses a block boundary. Returns the slots used.
+size_t generateLoop(Program& program, uint64_t& state, int depthLeft, size_t room) {
+    uint64_t r = splitmix64(state);
+    size_t begin = program.code.size();
+
+    CompiledInstruction loop;
+    loop.op = OpCode::FOR_BEGIN;
+    loop.flags = OPERAND_A_IMM;
+    loop.a = static_cast<int32_t>(r % 4) + 2;
+    r /= 4;
+    program.code.push_back(loop);
+
+    size_t bodySlots = 1 + r % std::min<size_t>(room - 2, 8);
+    size_t used = 0;
+    while (used < bodySlots) {
+        uint64_t next = splitmix64(state);
+        size_t left = bodySlots - used;
+        if (depthLeft > 1 && left >= 3 && next % 6 == 0) {
+            used += generateLoop(program, state, depthLeft - 1, left);
+        }
+        else {
+            program.code.push_back(simpleInstruction(next / 6));
+            ++used;
+        }
+    }
+
+    CompiledInstruction end;
+    end.op = OpCode::FOR_END;
+    program.code.push_back(end);
+    program.code[begin].b = static_cast<int32_t>(program.code.size() - begin);
+    return used + 2;
+}
+
+// Blocks are always full: the program ends when `length` instructions have
+// executed, not at a particular position
+void generateBlock(Program& program, size_t blockIndex) {
+    const size_t blockSize = ProgramGenerator::BLOCK_SIZE;
+
+    // Each block has its own stream, so blocks can be regenerated in any order
+    uint64_t state = program.seed ^ (blockIndex * 0xD1B54A32D192ED03ULL);
+    program.code.clear();
+    program.code.reserve(std::min(blockSize, program.length));
+    program.blockStart = blockIndex * blockSize;
+
+    while (program.code.size() < blockSize) {
+        size_t room = blockSize - program.code.size();
+        if (program.forDepth > 0 && room >= 3 && splitmix64(state) % 6 == 0) {
+            generateLoop(program, state, program.forDepth, room);
+        }
+        else {
+            program.code.push_back(simpleInstruction(splitmix64(state)));
+        }
+    }
+}
+
+}
+
+Program ProgramGenerator::makeProcedural(uint64_t seed, size_t length, int forDepth) {
+    Program program;
+    program.procedural = true;
+    program.seed = seed;
+    program.length = length;
+    program.forDepth = forDepth;
+    return program;
+}
+
+const CompiledInstruction& ProgramGenerator::fetch(Program& program, size_t index, const std::string& owner) {
+    if (!program.procedural) return program.code[index];
+
+    if (program.strings.empty()) {
+        program.strings.push_back("Hello from " + owner);
+        program.slotNames.assign(GENERATED_VARIABLES, GENERATED_VARIABLES + GENERATED_VARIABLE_COUNT);
+    }
+
+    bool loaded = !program.code.empty()
+        && index >= program.blockStart && index < program.blockStart + program.code.size();
+    if (!loaded) generateBlock(program, index / BLOCK_SIZE);
+
+    return program.code[index - program.blockStart];
+}
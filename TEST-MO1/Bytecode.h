@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct Instruction;
+
+// Opcodes of the pre-resolved instruction format
+enum class OpCode : uint8_t {
+    NOP,
+    PRINT,
+    DECLARE,
+    ADD,
+    SUBTRACT,
+    SLEEP,
+    ERROR,
+    FOR_BEGIN,   // a = repeat count, b = offset past the matching FOR_END
+    FOR_END
+};
+
+// Operand flags: when set, the operand is an immediate instead of a variable slot
+constexpr uint8_t OPERAND_A_IMM = 0x1;
+constexpr uint8_t OPERAND_B_IMM = 0x2;
+
+// Fixed-size compiled instruction. Variables are resolved to slot indices
+// into the process register array, literals to integer immediates, and
+// strings (PRINT text, error messages) to indices into Program::strings.
+struct CompiledInstruction {
+    OpCode op = OpCode::NOP;
+    uint8_t flags = 0;
+    uint16_t dst = 0;
+    int32_t a = 0;
+    int32_t b = 0;
+};
+
+// A program is either fully materialized in `code`, or procedural: only a
+// seed and length are stored and `code` holds the one block of generated
+// instructions that covers the program counter (see ProgramGenerator).
+//
+// `length` counts executed instructions with loops expanded; FOR_BEGIN and
+// FOR_END are bookkeeping and never count as executed instructions.
+struct Program {
+    std::vector<CompiledInstruction> code;
+    std::vector<std::string> strings;
+    std::vector<std::string> slotNames;
+
+    size_t length = 0;
+
+    bool procedural = false;
+    uint64_t seed = 0;
+    size_t blockStart = 0;
+    int forDepth = 0;
+
+    size_t size() const { return length; }
+
+    // Heap bytes held for instructions, strings and slot names
+    size_t footprint() const;
+};
+
+// Seed-based dummy programs, generated block by block on demand
+class ProgramGenerator {
+public:
+    static constexpr size_t BLOCK_SIZE = 64;
+
+    // forDepth > 0 lets blocks contain FOR loops nested up to that depth
+    static Program makeProcedural(uint64_t seed, size_t length, int forDepth = 0);
+
+    // Ensures program.code holds the block containing `index`. The first
+    // call also fills the PRINT text for `owner` and the variable slots.
+    static const CompiledInstruction& fetch(Program& program, size_t index, const std::string& owner);
+};
+
+class BytecodeCompiler {
+public:
+    // Compiles a parsed instruction list; malformed instructions become
+    // ERROR ops so they still fail at execution time like before.
+    static Program compile(const std::vector<Instruction>& instructions);
+
+    // Executed instruction count of a parsed list, loops expanded
+    static uint64_t expandedLength(const std::vector<Instruction>& instructions);
+
+private:
+    static bool isNumber(const std::string& s);
+};
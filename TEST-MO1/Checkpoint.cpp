@@ -0,0 +1,273 @@
+#include "Checkpoint.h"
+#include "Config.h"
+#include "MemoryManager.h"
+#include "ProcessManager.h"
+#include "Scheduler.h"
+#include "Screen.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <tuple>
+#include <unordered_map>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+extern std::atomic<int> globalProcessId;
+
+namespace {
+
+// The magic only identifies the file type; the layout is versioned by VERSION
+const char MAGIC[8] = { 'C', 'S', 'C', 'K', 'P', 'T', '\r', '\n' };
+const uint32_t VERSION = 2;
+
+// Read-only view of a whole file: mmap where available, otherwise the
+// file is read into memory
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+#ifdef _WIN32
+        std::ifstream file(path, std::ios::binary);
+        if (!file) throw std::runtime_error("Cannot open " + path + ".");
+        copy.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        bytes = reinterpret_cast<const uint8_t*>(copy.data());
+        length = copy.size();
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("Cannot open " + path + ".");
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Cannot read " + path + ".");
+        }
+        length = static_cast<size_t>(info.st_size);
+        if (length > 0) {
+            void* mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("Cannot map " + path + ".");
+            }
+            bytes = static_cast<const uint8_t*>(mapped);
+        }
+        ::close(fd);
+#endif
+    }
+
+    ~MappedFile() {
+#ifndef _WIN32
+        if (bytes) munmap(const_cast<uint8_t*>(bytes), length);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const uint8_t* data() const { return bytes; }
+    size_t size() const { return length; }
+
+private:
+    const uint8_t* bytes = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    std::string copy;
+#endif
+};
+
+void writeConfig(CheckpointWriter& out, const Config& cfg) {
+    out.put<int32_t>(cfg.numCpu);
+    out.put<int32_t>(cfg.batchFreq);
+    out.put<int32_t>(cfg.minIns);
+    out.put<int32_t>(cfg.maxIns);
+    out.put<int32_t>(cfg.delayPerExec);
+    out.putString(cfg.schedulerType);
+    out.put<int32_t>(cfg.quantum);
+    out.putString(cfg.quantumMode);
+    out.put<int32_t>(cfg.quantumMin);
+    out.put<int32_t>(cfg.quantumMax);
+    out.put<int32_t>(cfg.quantumAdaptInterval);
+    out.put<int32_t>(cfg.mlfqLevels);
+    out.putArray(cfg.mlfqQuanta);
+    out.put<int32_t>(cfg.mlfqBoostPeriod);
+    out.putString(cfg.cpuAffinity);
+    out.putArray(cfg.cpuAffinityMap);
+    out.put<int32_t>(cfg.softAffinity);
+    out.putString(cfg.idleStrategy);
+    out.put<int32_t>(cfg.idleSpinUs);
+    out.putString(cfg.clockMode);
+    out.put<uint32_t>(cfg.seed);
+    out.putString(cfg.arrivalMode);
+    out.put<double>(cfg.arrivalRate);
+    out.put<int32_t>(cfg.burstSize);
+    out.put<int32_t>(cfg.maxProcesses);
+    out.putString(cfg.programMode);
+    out.put<int32_t>(cfg.forNestingDepth);
+    out.put<int32_t>(cfg.maxOverallMem);
+    out.put<int32_t>(cfg.memPerFrame);
+    out.put<int32_t>(cfg.memPerProc);
+    out.putString(cfg.pageReplacement);
+    out.putString(cfg.backingStoreFile);
+}
+
+Config readConfig(CheckpointReader& in) {
+    Config cfg;
+    cfg.numCpu = in.get<int32_t>();
+    cfg.batchFreq = in.get<int32_t>();
+    cfg.minIns = in.get<int32_t>();
+    cfg.maxIns = in.get<int32_t>();
+    cfg.delayPerExec = in.get<int32_t>();
+    cfg.schedulerType = in.getString();
+    cfg.quantum = in.get<int32_t>();
+    cfg.quantumMode = in.getString();
+    cfg.quantumMin = in.get<int32_t>();
+    cfg.quantumMax = in.get<int32_t>();
+    cfg.quantumAdaptInterval = in.get<int32_t>();
+    cfg.mlfqLevels = in.get<int32_t>();
+    cfg.mlfqQuanta = in.getArray<int>();
+    cfg.mlfqBoostPeriod = in.get<int32_t>();
+    cfg.cpuAffinity = in.getString();
+    cfg.cpuAffinityMap = in.getArray<int>();
+    cfg.softAffinity = in.get<int32_t>();
+    cfg.idleStrategy = in.getString();
+    cfg.idleSpinUs = in.get<int32_t>();
+    cfg.clockMode = in.getString();
+    cfg.seed = in.get<uint32_t>();
+    cfg.arrivalMode = in.getString();
+    cfg.arrivalRate = in.get<double>();
+    cfg.burstSize = in.get<int32_t>();
+    cfg.maxProcesses = in.get<int32_t>();
+    cfg.programMode = in.getString();
+    cfg.forNestingDepth = in.get<int32_t>();
+    cfg.maxOverallMem = in.get<int32_t>();
+    cfg.memPerFrame = in.get<int32_t>();
+    cfg.memPerProc = in.get<int32_t>();
+    cfg.pageReplacement = in.getString();
+    cfg.backingStoreFile = in.getString();
+
+    if (cfg.numCpu < 1 || cfg.numCpu > 128) throw std::runtime_error("Checkpoint has an invalid config.");
+    return cfg;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+Checkpoint::Result Checkpoint::save(const std::string& path, const Scheduler* scheduler) {
+    auto start = std::chrono::steady_clock::now();
+    Result result;
+
+    std::vector<std::shared_ptr<Screen>> processes;
+    ProcessManager::forEachProcess([&processes](const std::shared_ptr<Screen>& process) {
+        processes.push_back(process);
+    });
+
+    CheckpointWriter out;
+    out.put(MAGIC);
+    out.put<uint32_t>(VERSION);
+    out.put<uint64_t>(scheduler ? scheduler->clockNow() : 0);
+    out.put<int32_t>(scheduler ? scheduler->getDummyCount() : 0);
+    out.put<int32_t>(globalProcessId.load());
+    writeConfig(out, config);
+
+    // Runnable processes in the order they will be queued again: running
+    // ones first, then ready and sleeping ones by how long they have waited
+    std::vector<std::tuple<int, uint64_t, int32_t>> order;
+    out.put<uint64_t>(processes.size());
+    for (const auto& process : processes) {
+        uint64_t since = 0;
+        ProcessStatus status = process->saveCheckpoint(out, since);
+        if (status == ProcessStatus::RUNNING) order.emplace_back(0, since, process->getProcessId());
+        else if (status == ProcessStatus::READY) order.emplace_back(1, since, process->getProcessId());
+        else if (status == ProcessStatus::WAITING) order.emplace_back(2, since, process->getProcessId());
+    }
+    std::stable_sort(order.begin(), order.end());
+
+    std::vector<int32_t> queued;
+    queued.reserve(order.size());
+    for (const auto& entry : order) queued.push_back(std::get<2>(entry));
+    out.putArray(queued);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) throw std::runtime_error("Cannot create " + path + ".");
+    file.write(out.data().data(), static_cast<std::streamsize>(out.data().size()));
+    file.close();
+    if (!file) throw std::runtime_error("Failed to write " + path + ".");
+
+    result.processes = processes.size();
+    result.queued = queued.size();
+    result.bytes = out.data().size();
+    result.seconds = secondsSince(start);
+    return result;
+}
+
+Checkpoint::Image Checkpoint::load(const std::string& path, Result& result) {
+    auto start = std::chrono::steady_clock::now();
+    Image image;
+
+    MappedFile file(path);
+    CheckpointReader in(file.data(), file.size());
+
+    char magic[sizeof(MAGIC)];
+    for (char& c : magic) c = in.get<char>();
+    if (!std::equal(magic, magic + sizeof(MAGIC), MAGIC)) {
+        throw std::runtime_error(path + " is not a checkpoint file.");
+    }
+    if (in.get<uint32_t>() != VERSION) throw std::runtime_error("Unsupported checkpoint version.");
+
+    image.clock = in.get<uint64_t>();
+    image.dummies = in.get<int32_t>();
+    image.nextProcessId = in.get<int32_t>();
+    image.config = readConfig(in);
+    if (image.nextProcessId < 0) throw std::runtime_error("Checkpoint has an invalid process numbering.");
+
+    uint64_t count = in.get<uint64_t>();
+    std::unordered_map<int, std::shared_ptr<Screen>> byId;
+    for (uint64_t i = 0; i < count; ++i) {
+        std::shared_ptr<Screen> process = Screen::restoreCheckpoint(in);
+        int id = process->getProcessId();
+        if (id < 0 || id >= image.nextProcessId || !byId.emplace(id, process).second) {
+            throw std::runtime_error("Checkpoint has an invalid process id.");
+        }
+        image.processes.push_back(process);
+    }
+
+    std::vector<int32_t> queued = in.getArray<int32_t>();
+    image.ready.reserve(queued.size());
+    for (int32_t id : queued) {
+        auto found = byId.find(id);
+        if (found == byId.end()) throw std::runtime_error("Checkpoint queues an unknown process.");
+        image.ready.push_back(found->second);
+    }
+
+    result.processes = image.processes.size();
+    result.queued = image.ready.size();
+    result.bytes = file.size();
+    result.seconds = secondsSince(start);
+    return image;
+}
+
+Scheduler* Checkpoint::install(Image& image, Result& result) {
+    auto start = std::chrono::steady_clock::now();
+
+    config = image.config;
+    MemoryManager::configure(config);
+    ProcessManager::reset();
+    for (const auto& process : image.processes) {
+        if (process->getStatus() != ProcessStatus::FINISHED) process->attachMemory();
+        ProcessManager::registerProcess(process);
+    }
+    globalProcessId.store(image.nextProcessId);
+
+    Scheduler* scheduler = new Scheduler(config);
+    scheduler->resumeClock(image.clock, image.dummies);
+    scheduler->addProcesses(image.ready);
+
+    result.seconds += secondsSince(start);
+    return scheduler;
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "Config.h"
+
+class Scheduler;
+class Screen;
+
+// Append-only buffer for checkpoint records. Values are written in host
+// byte order; a checkpoint is meant to be restored on the machine (or at
+// least the architecture) that wrote it.
+class CheckpointWriter {
+public:
+    template <typename T>
+    void put(const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "put() copies raw bytes");
+        buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void putString(const std::string& text) {
+        put<uint32_t>(static_cast<uint32_t>(text.size()));
+        buffer.append(text);
+    }
+
+    template <typename T>
+    void putArray(const std::vector<T>& values) {
+        static_assert(std::is_trivially_copyable<T>::value, "putArray() copies raw bytes");
+        put<uint64_t>(values.size());
+        if (!values.empty()) buffer.append(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+    }
+
+    void putStrings(const std::vector<std::string>& values) {
+        put<uint64_t>(values.size());
+        for (const std::string& text : values) putString(text);
+    }
+
+    const std::string& data() const { return buffer; }
+
+private:
+    std::string buffer;
+};
+
+// Bounds-checked cursor over a checkpoint image (usually a read-only
+// mapping of the file). Throws std::runtime_error on truncated input.
+class CheckpointReader {
+public:
+    CheckpointReader(const uint8_t* data, size_t size) : cursor(data), end(data + size) {}
+
+    template <typename T>
+    T get() {
+        static_assert(std::is_trivially_copyable<T>::value, "get() copies raw bytes");
+        T value;
+        std::memcpy(&value, take(sizeof(T)), sizeof(T));
+        return value;
+    }
+
+    std::string getString() {
+        uint32_t length = get<uint32_t>();
+        return std::string(reinterpret_cast<const char*>(take(length)), length);
+    }
+
+    template <typename T>
+    std::vector<T> getArray() {
+        uint64_t count = get<uint64_t>();
+        if (count > remaining() / sizeof(T)) throw std::runtime_error("Checkpoint is truncated.");
+        std::vector<T> values(static_cast<size_t>(count));
+        if (count > 0) std::memcpy(values.data(), take(values.size() * sizeof(T)), values.size() * sizeof(T));
+        return values;
+    }
+
+    std::vector<std::string> getStrings() {
+        uint64_t count = get<uint64_t>();
+        if (count > remaining() / sizeof(uint32_t)) throw std::runtime_error("Checkpoint is truncated.");
+        std::vector<std::string> values;
+        values.reserve(static_cast<size_t>(count));
+        for (uint64_t i = 0; i < count; ++i) values.push_back(getString());
+        return values;
+    }
+
+    size_t remaining() const { return static_cast<size_t>(end - cursor); }
+
+private:
+    const uint8_t* take(size_t bytes) {
+        if (bytes > remaining()) throw std::runtime_error("Checkpoint is truncated.");
+        const uint8_t* start = cursor;
+        cursor += bytes;
+        return start;
+    }
+
+    const uint8_t* cursor;
+    const uint8_t* end;
+};
+
+// Whole-emulator snapshots: config, every process (program, instruction
+// pointer, loop stack, variables, status, accounting) and the order in
+// which runnable processes are queued.
+class Checkpoint {
+public:
+    struct Result {
+        size_t processes = 0;
+        size_t queued = 0;
+        size_t bytes = 0;
+        double seconds = 0.0;
+    };
+
+    // A decoded checkpoint that has not touched the running emulator
+    struct Image {
+        Config config;
+        uint64_t clock = 0;
+        int dummies = 0;
+        int nextProcessId = 0;
+        std::vector<std::shared_ptr<Screen>> processes;
+        std::vector<std::shared_ptr<Screen>> ready;   // in queue order
+    };
+
+    // Each process is copied under its own lock, so the scheduler may keep
+    // running; processes that finish meanwhile are saved as they were seen.
+    // Throws std::runtime_error if the file cannot be written.
+    static Result save(const std::string& path, const Scheduler* scheduler);
+
+    // Maps and decodes the whole file without changing any global state, so
+    // the running emulator survives a bad file. Throws std::runtime_error on
+    // a bad or truncated file, or a process id outside the saved numbering.
+    static Image load(const std::string& path, Result& result);
+
+    // Replaces the global config and the process table with the image and
+    // returns a new (not started) scheduler whose clock resumes where the
+    // checkpoint left off, with runnable processes queued in their saved
+    // order. Running processes are queued first; sleeping ones wake
+    // immediately. The previous scheduler must already be stopped.
+    static Scheduler* install(Image& image, Result& result);
+};
@@ -1,5 +1,7 @@
 #include "Config.h"
 #include <type_traits>
+#include <sstream>
+#include <algorithm>
 
 Config config;
 std::atomic<int> activeCores = 0;
@@ -31,7 +33,8 @@ void Config::loadConfig(const std::string& filename) {
                 file >> schedulerValue;
             }
 
-            if (schedulerValue == "fcfs" || schedulerValue == "rr") {
+            if (schedulerValue == "fcfs" || schedulerValue == "rr" || schedulerValue == "mlfq"
+                || schedulerValue == "sjf" || schedulerValue == "srtf") {
                 config.schedulerType = schedulerValue;
             }
             else {
@@ -43,6 +46,145 @@ void Config::loadConfig(const std::string& filename) {
             file >> value;
             config.quantum = clamp(value, 1, 429496729);
         }
+        else if (parameter == "quantum-mode") {
+            std::string modeValue;
+            file >> std::ws;
+
+            if (file.peek() == '"') {
+                file.get();
+                std::getline(file, modeValue, '"');
+            }
+            else {
+                file >> modeValue;
+            }
+
+            if (modeValue == "fixed" || modeValue == "adaptive") {
+                config.quantumMode = modeValue;
+            }
+            else {
+                throw std::runtime_error("Invalid quantum-mode value.");
+            }
+        }
+        else if (parameter == "quantum-min") {
+            int value;
+            file >> value;
+            config.quantumMin = clamp(value, 1, 429496729);
+        }
+        else if (parameter == "quantum-max") {
+            int value;
+            file >> value;
+            config.quantumMax = clamp(value, 1, 429496729);
+        }
+        else if (parameter == "quantum-adapt-interval") {
+            int value;
+            file >> value;
+            config.quantumAdaptInterval = clamp(value, 1, 429496729);
+        }
+        else if (parameter == "mlfq-levels") {
+            int value;
+            file >> value;
+            config.mlfqLevels = clamp(value, 1, 8);
+        }
+        else if (parameter == "mlfq-quanta") {
+            // Either one number or a quoted list such as "2 4 8"
+            std::string quantaValue;
+            file >> std::ws;
+
+            if (file.peek() == '"') {
+                file.get();
+                std::getline(file, quantaValue, '"');
+            }
+            else {
+                file >> quantaValue;
+            }
+
+            std::istringstream list(quantaValue);
+            std::vector<int> quanta;
+            int value;
+            while (list >> value) quanta.push_back(clamp(value, 1, 429496729));
+            if (quanta.empty() || !list.eof()) {
+                throw std::runtime_error("Invalid mlfq-quanta value.");
+            }
+            config.mlfqQuanta = quanta;
+        }
+        else if (parameter == "mlfq-boost-period") {
+            int value;
+            file >> value;
+            config.mlfqBoostPeriod = clamp(value, 0, 429496729);
+        }
+        else if (parameter == "cpu-affinity") {
+            std::string affinityValue;
+            file >> std::ws;
+
+            if (file.peek() == '"') {
+                file.get();
+                std::getline(file, affinityValue, '"');
+            }
+            else {
+                file >> affinityValue;
+            }
+
+            if (affinityValue == "none" || affinityValue == "pinned") {
+                config.cpuAffinity = affinityValue;
+            }
+            else {
+                throw std::runtime_error("Invalid cpu-affinity value.");
+            }
+        }
+        else if (parameter == "cpu-affinity-map") {
+            // Host CPU ids, either one number or a quoted list such as "0 2 4 6"
+            std::string mapValue;
+            file >> std::ws;
+
+            if (file.peek() == '"') {
+                file.get();
+                std::getline(file, mapValue, '"');
+            }
+            else {
+                file >> mapValue;
+            }
+
+            std::istringstream list(mapValue);
+            std::vector<int> hostCpus;
+            int value;
+            while (list >> value) {
+                if (value < 0) throw std::runtime_error("Invalid cpu-affinity-map value.");
+                hostCpus.push_back(value);
+            }
+            if (hostCpus.empty() || !list.eof()) {
+                throw std::runtime_error("Invalid cpu-affinity-map value.");
+            }
+            config.cpuAffinityMap = hostCpus;
+        }
+        else if (parameter == "soft-affinity") {
+            int value;
+            file >> value;
+            config.softAffinity = clamp(value, 0, 1);
+        }
+        else if (parameter == "idle-strategy") {
+            std::string strategyValue;
+            file >> std::ws;
+
+            if (file.peek() == '"') {
+                file.get();
+                std::getline(file, strategyValue, '"');
+            }
+            else {
+                file >> strategyValue;
+            }
+
+            if (strategyValue == "block" || strategyValue == "spin" || strategyValue == "spin-park") {
+                config.idleStrategy = strategyValue;
+            }
+            else {
+                throw std::runtime_error("Invalid idle-strategy value.");
+            }
+        }
+        else if (parameter == "idle-spin-us") {
+            int value;
+            file >> value;
+            config.idleSpinUs = clamp(value, 1, 1000000);
+        }
         else if (parameter == "batch-process-freq") {
             int value;
             file >> value;
@@ -63,10 +205,154 @@ void Config::loadConfig(const std::string& filename) {
             file >> value;
             config.delayPerExec = clamp(value, 0, 429496729);
         }
+        else if (parameter == "clock-mode") {
+            std::string modeValue;
+            file >> std::ws;
+
+            if (file.peek() == '"') {
+                file.get();
+                std::getline(file, modeValue, '"');
+            }
+            else {
+                file >> modeValue;
+            }
+
+            if (modeValue == "real" || modeValue == "virtual") {
+                config.clockMode = modeValue;
+            }
+            else {
+                throw std::runtime_error("Invalid clock-mode value.");
+            }
+        }
+        else if (parameter == "seed") {
+            unsigned int value;
+            file >> value;
+            config.seed = value;
+        }
+        else if (parameter == "arrival-mode") {
+            std::string modeValue;
+            file >> std::ws;
+
+            if (file.peek() == '"') {
+                file.get();
+                std::getline(file, modeValue, '"');
+            }
+            else {
+                file >> modeValue;
+            }
+
+            if (modeValue == "fixed" || modeValue == "poisson" || modeValue == "burst") {
+                config.arrivalMode = modeValue;
+            }
+            else {
+                throw std::runtime_error("Invalid arrival-mode value.");
+            }
+        }
+        else if (parameter == "arrival-rate") {
+            double value;
+            file >> value;
+            config.arrivalRate = value > 0.0 ? value : 0.0;
+        }
+        else if (parameter == "burst-size") {
+            int value;
+            file >> value;
+            config.burstSize = clamp(value, 1, 1000000);
+        }
+        else if (parameter == "max-processes") {
+            int value;
+            file >> value;
+            config.maxProcesses = clamp(value, 0, 16000000);
+        }
+        else if (parameter == "program-mode") {
+            std::string modeValue;
+            file >> std::ws;
+
+            if (file.peek() == '"') {
+                file.get();
+                std::getline(file, modeValue, '"');
+            }
+            else {
+                file >> modeValue;
+            }
+
+            if (modeValue == "procedural" || modeValue == "materialized") {
+                config.programMode = modeValue;
+            }
+            else {
+                throw std::runtime_error("Invalid program-mode value.");
+            }
+        }
+        else if (parameter == "for-nesting-depth") {
+            int value;
+            file >> value;
+            config.forNestingDepth = clamp(value, 0, 8);
+        }
+        else if (parameter == "max-overall-mem") {
+            int value;
+            file >> value;
+            config.maxOverallMem = clamp(value, 0, 1 << 30);
+        }
+        else if (parameter == "mem-per-frame") {
+            int value;
+            file >> value;
+            config.memPerFrame = clamp(value, 4, 65536);
+        }
+        else if (parameter == "mem-per-proc") {
+            int value;
+            file >> value;
+            config.memPerProc = clamp(value, 4, 1 << 24);
+        }
+        else if (parameter == "page-replacement") {
+            std::string policyValue;
+            file >> std::ws;
+
+            if (file.peek() == '"') {
+                file.get();
+                std::getline(file, policyValue, '"');
+            }
+            else {
+                file >> policyValue;
+            }
+
+            if (policyValue == "fifo" || policyValue == "lru" || policyValue == "clock") {
+                config.pageReplacement = policyValue;
+            }
+            else {
+                throw std::runtime_error("Invalid page-replacement value.");
+            }
+        }
+        else if (parameter == "backing-store-file") {
+            std::string pathValue;
+            file >> std::ws;
+
+            if (file.peek() == '"') {
+                file.get();
+                std::getline(file, pathValue, '"');
+            }
+            else {
+                file >> pathValue;
+            }
+
+            if (pathValue.empty()) {
+                throw std::runtime_error("Invalid backing-store-file value.");
+            }
+            config.backingStoreFile = pathValue;
+        }
         else {
             std::cerr << "Unknown parameter in config file: " << parameter << std::endl;
         }
     }
 
     file.close();
-}
\ No newline at end of file
+}
+
+std::vector<int> Config::feedbackQuanta() const {
+    std::vector<int> quanta;
+    int next = quantum;
+    for (int level = 0; level < mlfqLevels; ++level) {
+        if (level < static_cast<int>(mlfqQuanta.size())) next = mlfqQuanta[level];
+        else if (level > 0) next = static_cast<int>(std::min(2LL * next, 429496729LL));
+        quanta.push_back(std::max(next, 1));
+    }
+    return quanta;
+}
@@ -2,13 +2,14 @@
 #define CONFIG_H
 
 #include <string>
+#include <vector>
 #include <atomic>
 #include <iostream>   // for std::cerr, std::endl
 #include <fstream>    // for std::ifstream
 #include <stdexcept>  // for std::runtime_error
 
 struct Config {
-    enum class SchedulerType { FCFS, RR };
+    enum class SchedulerType { FCFS, RR, MLFQ, SJF, SRTF };
 
     int numCpu = 4;
     int batchFreq = 1;
@@ -18,6 +19,71 @@ struct Config {
     std::string schedulerType = "fcfs";
     int quantum = 0;
 
+    // "adaptive" lets rr retune its quantum every quantum-adapt-interval ms
+    // (ticks in virtual mode) within [quantum-min, quantum-max], starting
+    // from quantum-cycles; "fixed" always uses quantum-cycles
+    std::string quantumMode = "fixed";
+    int quantumMin = 1;
+    int quantumMax = 100;
+    int quantumAdaptInterval = 100;
+
+    // "mlfq" scheduler: number of levels, one quantum per level (missing
+    // levels double the previous one, starting from quantum-cycles), and
+    // the aging period after which every process returns to the top level
+    // (ms, or ticks in virtual mode; 0 disables aging)
+    int mlfqLevels = 3;
+    std::vector<int> mlfqQuanta;
+    int mlfqBoostPeriod = 1000;
+
+    // Quantum of each MLFQ level, filled in from the settings above
+    std::vector<int> feedbackQuanta() const;
+
+    // "pinned" binds each core thread to a host CPU: core i runs on
+    // cpu-affinity-map[i % size], or on host CPU i % host cores without a
+    // map. soft-affinity 1 requeues preempted and woken processes on the
+    // core they last ran on.
+    std::string cpuAffinity = "none";
+    std::vector<int> cpuAffinityMap;
+    int softAffinity = 1;
+
+    // What an idle core does in real clock mode: "block" parks on its own
+    // condition variable at once, "spin" polls the ready queues with a CPU
+    // pause hint (yielding the host thread every idle-spin-us), and
+    // "spin-park" spins for idle-spin-us before parking. Producers wake
+    // one parked core directly, and none while another core is spinning.
+    std::string idleStrategy = "block";
+    int idleSpinUs = 50;
+
+    // "real" runs on wall time; "virtual" advances a global tick clock and
+    // measures delays, quantum, batch frequency and sleeps in ticks
+    std::string clockMode = "real";
+    unsigned int seed = 1;
+
+    // Dummy process arrivals: "fixed", "poisson" or "burst". arrival-rate is
+    // processes per second (per tick in virtual mode); 0 keeps one arrival
+    // every batch-process-freq. max-processes 0 means no limit.
+    std::string arrivalMode = "fixed";
+    double arrivalRate = 0.0;
+    int burstSize = 1;
+    int maxProcesses = 0;
+
+    // "procedural" dummy programs store only a seed and length and generate
+    // instructions on demand; "materialized" builds the whole program up front
+    std::string programMode = "procedural";
+
+    // Generated programs may contain FOR loops nested up to this depth (0 = none)
+    int forNestingDepth = 0;
+
+    // Demand paging, in bytes. max-overall-mem 0 keeps variables in
+    // per-process registers; otherwise they live in mem-per-proc bytes of
+    // paged memory split into mem-per-frame pages. page-replacement is
+    // "fifo", "lru" or "clock"; evicted pages go to backing-store-file.
+    int maxOverallMem = 0;
+    int memPerFrame = 16;
+    int memPerProc = 4096;
+    std::string pageReplacement = "fifo";
+    std::string backingStoreFile = "csopesy-backing-store.bin";
+
     void loadConfig(const std::string& filename);
 };
 
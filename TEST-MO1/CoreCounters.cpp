@@ -0,0 +1,36 @@
+#include "CoreCounters.h"
+
+CounterValues& CounterValues::operator+=(const CounterValues& other) {
+    busyTime += other.busyTime;
+    idleTime += other.idleTime;
+    instructions += other.instructions;
+    dispatches += other.dispatches;
+    preemptions += other.preemptions;
+    queueWait += other.queueWait;
+    lockWait += other.lockWait;
+    return *this;
+}
+
+CounterValues CounterValues::operator-(const CounterValues& earlier) const {
+    CounterValues delta;
+    delta.busyTime = busyTime - earlier.busyTime;
+    delta.idleTime = idleTime - earlier.idleTime;
+    delta.instructions = instructions - earlier.instructions;
+    delta.dispatches = dispatches - earlier.dispatches;
+    delta.preemptions = preemptions - earlier.preemptions;
+    delta.queueWait = queueWait - earlier.queueWait;
+    delta.lockWait = lockWait - earlier.lockWait;
+    return delta;
+}
+
+CounterValues CoreCounters::load() const {
+    CounterValues values;
+    values.busyTime = busyTime.load(std::memory_order_relaxed);
+    values.idleTime = idleTime.load(std::memory_order_relaxed);
+    values.instructions = instructions.load(std::memory_order_relaxed);
+    values.dispatches = dispatches.load(std::memory_order_relaxed);
+    values.preemptions = preemptions.load(std::memory_order_relaxed);
+    values.queueWait = queueWait.load(std::memory_order_relaxed);
+    values.lockWait = lockWait.load(std::memory_order_relaxed);
+    return values;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Plain copy of one core's counters. Times are in scheduler clock units
+// (nanoseconds, or ticks in virtual clock mode).
+struct CounterValues {
+    uint64_t busyTime = 0;
+    uint64_t idleTime = 0;
+    long long instructions = 0;
+    long long dispatches = 0;
+    long long preemptions = 0;
+    uint64_t queueWait = 0;
+    uint64_t lockWait = 0;
+
+    CounterValues& operator+=(const CounterValues& other);
+    // Change since an earlier sample of the same core
+    CounterValues operator-(const CounterValues& earlier) const;
+};
+
+// Hot-path counters for one emulated core. Only the owning core writes
+// them, and each block sits on its own cache line, so counting never
+// bounces a line between cores. Readers sum the blocks on demand.
+struct alignas(64) CoreCounters {
+    std::atomic<uint64_t> busyTime{ 0 };        // running processes
+    std::atomic<uint64_t> idleTime{ 0 };        // parked or nothing to run
+    std::atomic<long long> instructions{ 0 };
+    std::atomic<long long> dispatches{ 0 };
+    std::atomic<long long> preemptions{ 0 };    // slices ended by the quantum
+    std::atomic<uint64_t> queueWait{ 0 };       // ready to dispatch, summed over dispatches
+    std::atomic<uint64_t> lockWait{ 0 };        // blocked on ready queue locks
+
+    CounterValues load() const;
+};
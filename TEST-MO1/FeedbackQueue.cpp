@@ -0,0 +1,93 @@
+#include "FeedbackQueue.h"
+#include "Screen.h"
+#include <algorithm>
+
+FeedbackQueue::FeedbackQueue(std::vector<int> quanta, uint64_t boostPeriod_)
+    : boostPeriod(boostPeriod_)
+{
+    if (quanta.empty()) quanta.push_back(1);
+    for (int quantum : quanta) {
+        Level level;
+        level.quantum = std::max(quantum, 1);
+        levels.push_back(std::move(level));
+    }
+}
+
+// A process's stored level is only valid within the boost epoch it was set in
+void FeedbackQueue::push(const std::shared_ptr<Screen>& process, Reason reason, uint64_t now) {
+    boostIfDue(now);
+
+    int level = process->getPriorityLevel(epoch);
+    const int lowest = levelCount() - 1;
+    switch (reason) {
+    case Reason::ARRIVED:
+        level = 0;
+        break;
+    case Reason::PREEMPTED:
+        if (level < lowest) {
+            ++level;
+            ++demoted;
+        }
+        break;
+    case Reason::WOKE:
+        if (level > 0) {
+            --level;
+            ++promoted;
+        }
+        break;
+    }
+
+    process->setPriorityLevel(level, epoch);
+    levels[level].queue.push_back(Entry{ process, now });
+    ++count;
+}
+
+std::shared_ptr<Screen> FeedbackQueue::pop(uint64_t now, int& quantum) {
+    boostIfDue(now);
+
+    for (Level& level : levels) {
+        if (level.queue.empty()) continue;
+
+        Entry entry = std::move(level.queue.front());
+        level.queue.pop_front();
+        --count;
+
+        uint64_t wait = now > entry.enqueuedAt ? now - entry.enqueuedAt : 0;
+        level.dispatches++;
+        level.totalWait += wait;
+        level.maxWait = std::max(level.maxWait, wait);
+
+        quantum = level.quantum;
+        return entry.process;
+    }
+    return nullptr;
+}
+
+// Moves every queued process to level 0, oldest level first, and starts a new
+// epoch so running and sleeping processes are reset when they come back
+void FeedbackQueue::boostIfDue(uint64_t now) {
+    if (boostPeriod == 0 || now - lastBoost < boostPeriod) return;
+    lastBoost = now;
+    ++epoch;
+
+    std::deque<Entry>& top = levels[0].queue;
+    for (size_t i = 1; i < levels.size(); ++i) {
+        for (Entry& entry : levels[i].queue) top.push_back(std::move(entry));
+        levels[i].queue.clear();
+    }
+    for (Entry& entry : top) entry.process->setPriorityLevel(0, epoch);
+}
+
+std::vector<FeedbackQueue::LevelStats> FeedbackQueue::stats() const {
+    std::vector<LevelStats> result;
+    for (const Level& level : levels) {
+        LevelStats s;
+        s.quantum = level.quantum;
+        s.queued = level.queue.size();
+        s.dispatches = level.dispatches;
+        s.totalWait = level.totalWait;
+        s.maxWait = level.maxWait;
+        result.push_back(s);
+    }
+    return result;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "ReadyQueue.h"
+
+// Ready queue for the multi-level feedback queue scheduler.
+// New processes enter level 0; a process that uses its whole quantum drops
+// one level and one that sleeps rises one level. Every `boostPeriod` clock
+// units all processes, queued or not, return to level 0 so long-running
+// work cannot starve.
+class FeedbackQueue : public ReadyQueue {
+public:
+    struct LevelStats {
+        int quantum = 0;
+        size_t queued = 0;
+        long long dispatches = 0;
+        uint64_t totalWait = 0;    // enqueue to dispatch, in clock units
+        uint64_t maxWait = 0;
+    };
+
+    // One quantum per level; boostPeriod 0 disables aging
+    FeedbackQueue(std::vector<int> quanta, uint64_t boostPeriod);
+
+    void push(const std::shared_ptr<Screen>& process, Reason reason, uint64_t now) override;
+
+    // Highest-priority process, or null; `quantum` receives its level's quantum
+    std::shared_ptr<Screen> pop(uint64_t now, int& quantum) override;
+
+    size_t size() const override { return count; }
+    int levelCount() const { return static_cast<int>(levels.size()); }
+
+    std::vector<LevelStats> stats() const;
+    long long boosts() const { return epoch; }
+    long long demotions() const { return demoted; }
+    long long promotions() const { return promoted; }
+
+private:
+    struct Entry {
+        std::shared_ptr<Screen> process;
+        uint64_t enqueuedAt;
+    };
+
+    struct Level {
+        int quantum;
+        std::deque<Entry> queue;
+        long long dispatches = 0;
+        uint64_t totalWait = 0;
+        uint64_t maxWait = 0;
+    };
+
+    void boostIfDue(uint64_t now);
+
+    std::vector<Level> levels;
+    uint64_t boostPeriod;
+    uint64_t lastBoost = 0;
+    uint64_t epoch = 0;
+    size_t count = 0;
+    long long demoted = 0;
+    long long promoted = 0;
+};
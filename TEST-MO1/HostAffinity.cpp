@@ -0,0 +1,37 @@
+#include "HostAffinity.h"
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+int HostAffinity::hostCpuCount() {
+    unsigned int count = std::thread::hardware_concurrency();
+    return count > 0 ? static_cast<int>(count) : 1;
+}
+
+int HostAffinity::hostCpuFor(int coreId, const std::vector<int>& map) {
+    if (!map.empty()) return map[coreId % map.size()];
+    return coreId % hostCpuCount();
+}
+
+bool HostAffinity::pinCurrentThread(int hostCpu) {
+    if (hostCpu < 0) return false;
+
+#ifdef _WIN32
+    if (hostCpu >= static_cast<int>(sizeof(DWORD_PTR) * 8)) return false;
+    return SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << hostCpu) != 0;
+#elif defined(__linux__)
+    if (hostCpu >= CPU_SETSIZE) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(hostCpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    // No thread affinity API (e.g. macOS); run unpinned
+    return false;
+#endif
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <vector>
+
+// Pins scheduler threads to host CPUs.
+//
+// Emulated core i runs on map[i % map.size()], or on host CPU
+// i % hostCpuCount() when no map is given, so num-cpu may exceed the
+// number of host cores.
+class HostAffinity {
+public:
+    static int hostCpuCount();
+
+    // Host CPU for an emulated core under `map` (empty = round robin)
+    static int hostCpuFor(int coreId, const std::vector<int>& map);
+
+    // Restricts the calling thread to `hostCpu`; false if the OS refused
+    static bool pinCurrentThread(int hostCpu);
+};
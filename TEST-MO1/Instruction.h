@@ -9,6 +9,7 @@ enum class InstructionType { PRINT, DECLARE, ADD, SUBTRACT, SLEEP, FOR };
 struct Instruction {
     InstructionType type;
     std::vector<std::string> args;
+    std::vector<Instruction> body;
 };
 
 #endif
@@ -0,0 +1,100 @@
+#include "LatencyHistogram.h"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+
+int bucketFor(uint64_t value) {
+    int bucket = 0;
+    while (value > 0) {
+        value >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+uint64_t upperBound(int bucket) {
+    if (bucket == 0) return 0;
+    if (bucket >= 64) return UINT64_MAX;
+    return (1ULL << bucket) - 1;
+}
+
+}
+
+LatencyHistogram::LatencyHistogram()
+    : buckets(BUCKETS, 0)
+{
+}
+
+void LatencyHistogram::add(uint64_t value) {
+    ++buckets[bucketFor(value)];
+    ++samples;
+    largest = std::max(largest, value);
+    sum += static_cast<double>(value);
+}
+
+void SharedLatencyHistogram::add(uint64_t value) {
+    std::atomic<uint64_t>& bucket = buckets[bucketFor(value)];
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    sum.store(sum.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    if (value > largest.load(std::memory_order_relaxed)) largest.store(value, std::memory_order_relaxed);
+}
+
+void SharedLatencyHistogram::addTo(LatencyHistogram& out) const {
+    for (int i = 0; i < LatencyHistogram::BUCKETS; ++i) {
+        uint64_t count = buckets[i].load(std::memory_order_relaxed);
+        out.buckets[i] += count;
+        out.samples += count;
+    }
+    out.sum += static_cast<double>(sum.load(std::memory_order_relaxed));
+    out.largest = std::max(out.largest, largest.load(std::memory_order_relaxed));
+}
+
+double LatencyHistogram::mean() const {
+    return samples ? sum / samples : 0.0;
+}
+
+uint64_t LatencyHistogram::percentile(double p) const {
+    if (samples == 0) return 0;
+    uint64_t rank = static_cast<uint64_t>(p * samples);
+    if (rank >= samples) rank = samples - 1;
+
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKETS; ++i) {
+        seen += buckets[i];
+        if (seen > rank) return std::min(upperBound(i), largest);
+    }
+    return largest;
+}
+
+std::string LatencyHistogram::format(uint64_t value, bool virtualClock) {
+    std::ostringstream text;
+    if (virtualClock) text << value << " ticks";
+    else if (value < 1000000) text << std::fixed << std::setprecision(1) << value / 1e3 << " us";
+    else text << std::fixed << std::setprecision(2) << value / 1e6 << " ms";
+    return text.str();
+}
+
+void LatencyHistogram::print(std::ostream& out, const std::string& title, bool virtualClock) const {
+    out << title << " (" << samples << " processes):\n";
+    if (samples == 0) {
+        out << "  No samples.\n";
+        return;
+    }
+
+    const int width = 40;
+    uint64_t tallest = *std::max_element(buckets.begin(), buckets.end());
+    for (int i = 0; i < BUCKETS; ++i) {
+        if (buckets[i] == 0) continue;
+        uint64_t low = i == 0 ? 0 : upperBound(i - 1) + 1;
+        int bar = static_cast<int>(buckets[i] * width / tallest);
+        out << "  " << std::right << std::setw(12) << format(low, virtualClock)
+            << " - " << std::setw(12) << format(upperBound(i), virtualClock)
+            << std::setw(8) << buckets[i] << " " << std::string(std::max(bar, 1), '#') << "\n";
+    }
+    out << "  Mean " << format(static_cast<uint64_t>(mean()), virtualClock)
+        << "   p50 <= " << format(percentile(0.50), virtualClock)
+        << "   p99 <= " << format(percentile(0.99), virtualClock)
+        << "   Max " << format(largest, virtualClock) << "\n";
+}
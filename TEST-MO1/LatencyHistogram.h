@@ -0,0 +1,51 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Power-of-two histogram of scheduler clock durations (nanoseconds, or
+// ticks in virtual clock mode). Bucket i holds values in [2^(i-1), 2^i),
+// with bucket 0 holding zero. Not thread-safe: fill it from one thread.
+class LatencyHistogram {
+public:
+    LatencyHistogram();
+
+    void add(uint64_t value);
+    uint64_t count() const { return samples; }
+    double mean() const;
+    uint64_t max() const { return largest; }
+    // Upper bound of the bucket holding the p-th percentile (0 < p <= 1)
+    uint64_t percentile(double p) const;
+
+    // Non-empty buckets with a bar per row, then count/mean/p50/p99/max
+    void print(std::ostream& out, const std::string& title, bool virtualClock) const;
+
+    // "12.34 ms" (or "56.7 us" below 1 ms) in real mode, "123 ticks" in virtual mode
+    static std::string format(uint64_t value, bool virtualClock);
+
+private:
+    friend class SharedLatencyHistogram;
+    static constexpr int BUCKETS = 65;
+
+    std::vector<uint64_t> buckets;
+    uint64_t samples = 0;
+    uint64_t largest = 0;
+    double sum = 0.0;
+};
+
+// The same buckets kept in relaxed atomics, so one thread can fill it on a
+// hot path while reports copy it out. Single writer.
+class SharedLatencyHistogram {
+public:
+    void add(uint64_t value);
+    // Adds every sample recorded so far to `out`
+    void addTo(LatencyHistogram& out) const;
+
+private:
+    std::atomic<uint64_t> buckets[LatencyHistogram::BUCKETS] = {};
+    std::atomic<uint64_t> sum{ 0 };
+    std::atomic<uint64_t> largest{ 0 };
+};
@@ -0,0 +1,288 @@
+#include "LogWriter.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+constexpr int MAX_CORES = 128;                 // matches the num-cpu limit
+constexpr size_t RING_CAPACITY = 4096;         // records per core, power of two
+constexpr size_t SHARED_CAPACITY = 16384;      // records in the shared buffer
+constexpr size_t MAX_OPEN_FILES = 64;
+constexpr size_t BATCH_WAKE_BYTES = 256 * 1024;
+constexpr auto FLUSH_INTERVAL = std::chrono::milliseconds(50);
+
+struct Record {
+    std::string file;
+    std::string line;
+};
+
+// Single-producer / single-consumer ring owned by one core thread
+struct Ring {
+    std::vector<Record> slots = std::vector<Record>(RING_CAPACITY);
+    alignas(64) std::atomic<size_t> head{ 0 };
+    alignas(64) std::atomic<size_t> tail{ 0 };
+
+    bool push(Record& record) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == RING_CAPACITY) return false;
+
+        slots[t & (RING_CAPACITY - 1)] = std::move(record);
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    template <typename F>
+    void drain(F&& consume) {
+        size_t h = head.load(std::memory_order_relaxed);
+        size_t t = tail.load(std::memory_order_acquire);
+        for (; h != t; ++h) {
+            consume(slots[h & (RING_CAPACITY - 1)]);
+        }
+        head.store(t, std::memory_order_release);
+    }
+};
+
+// Bounded set of open log files, least recently used is closed first
+class FileCache {
+public:
+    std::ofstream* get(const std::string& file) {
+        auto it = open.find(file);
+        if (it != open.end()) {
+            lru.splice(lru.begin(), lru, it->second.second);
+            return it->second.first.get();
+        }
+
+        if (open.size() >= MAX_OPEN_FILES) {
+            open.erase(lru.back());
+            lru.pop_back();
+        }
+
+        auto stream = std::make_unique<std::ofstream>(file, std::ios::app);
+        if (!stream->is_open()) return nullptr;
+
+        lru.push_front(file);
+        std::ofstream* raw = stream.get();
+        open.emplace(file, std::make_pair(std::move(stream), lru.begin()));
+        return raw;
+    }
+
+    void flushAll() {
+        for (auto& entry : open) entry.second.first->flush();
+    }
+
+    void closeAll() {
+        open.clear();
+        lru.clear();
+    }
+
+private:
+    std::list<std::string> lru;
+    std::unordered_map<std::string,
+        std::pair<std::unique_ptr<std::ofstream>, std::list<std::string>::iterator>> open;
+};
+
+struct State {
+    std::atomic<Ring*> rings[MAX_CORES] = {};
+    std::mutex ringAllocMutex;
+
+    std::mutex sharedMutex;
+    std::vector<Record> shared;
+
+    std::atomic<bool> running{ false };
+    std::thread writer;
+
+    std::mutex wakeMutex;
+    std::condition_variable wakeCv;
+    std::condition_variable flushedCv;
+    unsigned long long flushRequests = 0;
+    unsigned long long flushesDone = 0;
+
+    std::atomic<unsigned long long> pendingBytes{ 0 };
+    std::atomic<unsigned long long> queuedBytes{ 0 };
+    std::atomic<unsigned long long> writtenBytes{ 0 };
+    std::atomic<unsigned long long> droppedBytes{ 0 };
+    std::atomic<unsigned long long> droppedRecords{ 0 };
+    std::atomic<unsigned long long> batches{ 0 };
+
+    FileCache files;
+};
+
+State state;
+thread_local Ring* localRing = nullptr;
+
+void wakeWriter() {
+    std::lock_guard<std::mutex> lock(state.wakeMutex);
+    state.wakeCv.notify_one();
+}
+
+// Drains every buffer, then appends each file's lines with a single write
+void writeBatch() {
+    std::unordered_map<std::string, std::string> batch;
+    auto collect = [&batch](Record& record) {
+        std::string& out = batch[record.file];
+        out += record.line;
+        out += '\n';
+    };
+
+    for (int i = 0; i < MAX_CORES; ++i) {
+        Ring* ring = state.rings[i].load(std::memory_order_acquire);
+        if (ring) ring->drain(collect);
+    }
+
+    std::vector<Record> shared;
+    {
+        std::lock_guard<std::mutex> lock(state.sharedMutex);
+        shared.swap(state.shared);
+    }
+    for (Record& record : shared) collect(record);
+
+    if (batch.empty()) return;
+
+    unsigned long long bytes = 0;
+    for (auto& entry : batch) {
+        std::ofstream* out = state.files.get(entry.first);
+        if (out) {
+            out->write(entry.second.data(), entry.second.size());
+            state.writtenBytes.fetch_add(entry.second.size(), std::memory_order_relaxed);
+        }
+        else {
+            state.droppedBytes.fetch_add(entry.second.size(), std::memory_order_relaxed);
+        }
+        bytes += entry.second.size();
+    }
+    state.files.flushAll();
+    state.pendingBytes.fetch_sub(bytes, std::memory_order_relaxed);
+    state.batches.fetch_add(1, std::memory_order_relaxed);
+}
+
+void writerLoop() {
+    while (true) {
+        unsigned long long requested;
+        bool stopping;
+        {
+            std::unique_lock<std::mutex> lock(state.wakeMutex);
+            state.wakeCv.wait_for(lock, FLUSH_INTERVAL, [] {
+                return !state.running.load()
+                    || state.flushRequests != state.flushesDone
+                    || state.pendingBytes.load(std::memory_order_relaxed) >= BATCH_WAKE_BYTES;
+            });
+            requested = state.flushRequests;
+            stopping = !state.running.load();
+        }
+
+        writeBatch();
+
+        {
+            std::lock_guard<std::mutex> lock(state.wakeMutex);
+            state.flushesDone = requested;
+        }
+        state.flushedCv.notify_all();
+
+        if (stopping) break;
+    }
+
+    writeBatch();
+    state.files.closeAll();
+}
+
+void drop(const Record& record) {
+    state.droppedRecords.fetch_add(1, std::memory_order_relaxed);
+    state.droppedBytes.fetch_add(record.line.size() + 1, std::memory_order_relaxed);
+}
+
+}
+
+void LogWriter::start() {
+    bool expected = false;
+    if (!state.running.compare_exchange_strong(expected, true)) return;
+    state.writer = std::thread(writerLoop);
+}
+
+void LogWriter::shutdown() {
+    if (!state.running.exchange(false)) return;
+    wakeWriter();
+    if (state.writer.joinable()) state.writer.join();
+}
+
+void LogWriter::bindCore(int coreId) {
+    if (coreId < 0 || coreId >= MAX_CORES) {
+        localRing = nullptr;
+        return;
+    }
+
+    Ring* ring = state.rings[coreId].load(std::memory_order_acquire);
+    if (!ring) {
+        std::lock_guard<std::mutex> lock(state.ringAllocMutex);
+        ring = state.rings[coreId].load(std::memory_order_acquire);
+        if (!ring) {
+            ring = new Ring();
+            state.rings[coreId].store(ring, std::memory_order_release);
+        }
+    }
+    localRing = ring;
+}
+
+void LogWriter::write(const std::string& file, std::string line) {
+    Record record{ file, std::move(line) };
+
+    // Without a writer thread (e.g. tools linking the emulator) append directly
+    if (!state.running.load(std::memory_order_relaxed)) {
+        std::ofstream out(record.file, std::ios::app);
+        if (out.is_open()) {
+            out << record.line << '\n';
+            state.writtenBytes.fetch_add(record.line.size() + 1, std::memory_order_relaxed);
+        }
+        return;
+    }
+
+    size_t bytes = record.line.size() + 1;
+    if (localRing) {
+        if (!localRing->push(record)) {
+            drop(record);
+            return;
+        }
+    }
+    else {
+        std::lock_guard<std::mutex> lock(state.sharedMutex);
+        if (state.shared.size() >= SHARED_CAPACITY) {
+            drop(record);
+            return;
+        }
+        state.shared.push_back(std::move(record));
+    }
+
+    state.queuedBytes.fetch_add(bytes, std::memory_order_relaxed);
+    unsigned long long before = state.pendingBytes.fetch_add(bytes, std::memory_order_relaxed);
+    if (before < BATCH_WAKE_BYTES && before + bytes >= BATCH_WAKE_BYTES) {
+        wakeWriter();
+    }
+}
+
+void LogWriter::flush() {
+    if (!state.running.load()) return;
+
+    std::unique_lock<std::mutex> lock(state.wakeMutex);
+    unsigned long long target = ++state.flushRequests;
+    state.wakeCv.notify_one();
+    state.flushedCv.wait(lock, [target] {
+        return state.flushesDone >= target || !state.running.load();
+    });
+}
+
+void LogWriter::printStats(std::ostream& out) {
+    out << "Logging:\n"
+        << "Bytes Queued:    " << state.queuedBytes.load() << "\n"
+        << "Bytes Written:   " << state.writtenBytes.load() << "\n"
+        << "Bytes Pending:   " << state.pendingBytes.load() << "\n"
+        << "Bytes Dropped:   " << state.droppedBytes.load()
+        << " (" << state.droppedRecords.load() << " lines)\n"
+        << "Batches Written: " << state.batches.load() << "\n";
+}
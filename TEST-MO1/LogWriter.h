@@ -0,0 +1,28 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+
+// Asynchronous, batched writer for process log files.
+//
+// Each CPU core thread appends to its own lock-free single-producer ring;
+// other threads (CLI, generator, timer) share a locked buffer. A background
+// thread drains the buffers, groups lines per file and appends each batch
+// through a bounded LRU cache of open files. Batches are written every
+// flush interval, or sooner once enough bytes are queued.
+class LogWriter {
+public:
+    static void start();
+    static void shutdown();
+
+    // Binds the calling thread to the lock-free buffer of a CPU core
+    static void bindCore(int coreId);
+
+    // Queues one line (without trailing newline) for `file`
+    static void write(const std::string& file, std::string line);
+
+    // Blocks until everything queued before the call is written to disk
+    static void flush();
+
+    static void printStats(std::ostream& out);
+};
@@ -0,0 +1,309 @@
+#include "MemoryManager.h"
+#include "BackingStore.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <list>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+// Chooses which resident frame to evict. Frames are reported when they are
+// loaded, accessed and freed.
+class ReplacementPolicy {
+public:
+    virtual ~ReplacementPolicy() = default;
+    virtual void loaded(int frame) = 0;
+    virtual void touched(int frame) = 0;
+    virtual void freed(int frame) = 0;
+    virtual int victim() = 0;
+};
+
+// Oldest load first; LRU additionally moves a frame to the back on access
+class QueuePolicy : public ReplacementPolicy {
+public:
+    QueuePolicy(size_t frames, bool recency) : positions(frames), queued(frames, false), lru(recency) {}
+
+    void loaded(int frame) override {
+        order.push_back(frame);
+        positions[frame] = std::prev(order.end());
+        queued[frame] = true;
+    }
+    void touched(int frame) override {
+        if (lru && queued[frame]) order.splice(order.end(), order, positions[frame]);
+    }
+    void freed(int frame) override {
+        if (!queued[frame]) return;
+        order.erase(positions[frame]);
+        queued[frame] = false;
+    }
+    int victim() override {
+        int frame = order.front();
+        freed(frame);
+        return frame;
+    }
+
+private:
+    std::list<int> order;
+    std::vector<std::list<int>::iterator> positions;
+    std::vector<bool> queued;
+    bool lru;
+};
+
+// Second chance: the hand clears reference bits until it finds a frame
+// that was not used since the last sweep
+class ClockPolicy : public ReplacementPolicy {
+public:
+    explicit ClockPolicy(size_t frames) : referenced(frames, false), resident(frames, false) {}
+
+    void loaded(int frame) override { resident[frame] = true; referenced[frame] = true; }
+    void touched(int frame) override { referenced[frame] = true; }
+    void freed(int frame) override { resident[frame] = false; referenced[frame] = false; }
+    int victim() override {
+        while (true) {
+            size_t frame = hand;
+            hand = (hand + 1) % resident.size();
+            if (!resident[frame]) continue;
+            if (referenced[frame]) {
+                referenced[frame] = false;
+                continue;
+            }
+            resident[frame] = false;
+            return static_cast<int>(frame);
+        }
+    }
+
+private:
+    std::vector<bool> referenced;
+    std::vector<bool> resident;
+    size_t hand = 0;
+};
+
+struct Frame {
+    int processId = -1;
+    uint32_t page = 0;
+    bool dirty = false;
+};
+
+struct PageTable {
+    std::vector<int> frameOf;           // -1 when not resident
+    std::vector<int64_t> backingSlot;   // -1 until first paged out
+    std::shared_ptr<MemoryManager::PageStats> stats;
+};
+
+struct State {
+    std::mutex mtx;
+    bool enabled = false;
+    std::string policyName;
+
+    size_t frameSize = 0;
+    size_t pagesPerProcess = 0;
+    uint32_t addressLimit = 0;
+
+    std::vector<uint8_t> physical;
+    std::vector<Frame> frames;
+    std::vector<int> freeFrames;
+    std::unique_ptr<ReplacementPolicy> policy;
+    std::unordered_map<int, PageTable> tables;
+    BackingStore store;
+
+    std::atomic<size_t> usedFrames{ 0 };
+    std::atomic<uint64_t> pageIns{ 0 };
+    std::atomic<uint64_t> pageOuts{ 0 };
+};
+
+State& state() {
+    static State instance;
+    return instance;
+}
+
+PageTable& tableFor(State& s, int processId) {
+    auto it = s.tables.find(processId);
+    if (it != s.tables.end()) return it->second;
+
+    PageTable& table = s.tables[processId];
+    table.frameOf.assign(s.pagesPerProcess, -1);
+    table.backingSlot.assign(s.pagesPerProcess, -1);
+    table.stats = std::make_shared<MemoryManager::PageStats>();
+    return table;
+}
+
+void evict(State& s, int frameIndex) {
+    Frame& frame = s.frames[frameIndex];
+    PageTable& owner = s.tables[frame.processId];
+
+    // A clean page is either still zero or already matches its backing slot
+    if (frame.dirty) {
+        int64_t& slot = owner.backingSlot[frame.page];
+        if (slot < 0) slot = s.store.allocate();
+        s.store.writePage(slot, &s.physical[frameIndex * s.frameSize]);
+    }
+
+    owner.frameOf[frame.page] = -1;
+    owner.stats->pageOuts.fetch_add(1, std::memory_order_relaxed);
+    owner.stats->residentPages.fetch_sub(1, std::memory_order_relaxed);
+    s.pageOuts.fetch_add(1, std::memory_order_relaxed);
+    s.usedFrames.fetch_sub(1, std::memory_order_relaxed);
+    frame = Frame();
+}
+
+// Returns the physical byte offset of `address`, paging it in if needed
+size_t resolve(State& s, int processId, uint32_t address, bool writing) {
+    if (address + sizeof(int32_t) > s.addressLimit) {
+        std::ostringstream message;
+        message << "Memory access violation at 0x" << std::hex << address;
+        throw std::out_of_range(message.str());
+    }
+
+    PageTable& table = tableFor(s, processId);
+    uint32_t page = static_cast<uint32_t>(address / s.frameSize);
+    int frameIndex = table.frameOf[page];
+
+    if (frameIndex < 0) {
+        if (s.freeFrames.empty()) {
+            int victim = s.policy->victim();
+            evict(s, victim);
+            s.freeFrames.push_back(victim);
+        }
+        frameIndex = s.freeFrames.back();
+        s.freeFrames.pop_back();
+
+        uint8_t* data = &s.physical[frameIndex * s.frameSize];
+        int64_t slot = table.backingSlot[page];
+        if (slot >= 0) s.store.readPage(slot, data);
+        else std::memset(data, 0, s.frameSize);
+
+        s.frames[frameIndex].processId = processId;
+        s.frames[frameIndex].page = page;
+        s.frames[frameIndex].dirty = false;
+        table.frameOf[page] = frameIndex;
+        s.policy->loaded(frameIndex);
+
+        table.stats->pageIns.fetch_add(1, std::memory_order_relaxed);
+        table.stats->residentPages.fetch_add(1, std::memory_order_relaxed);
+        s.pageIns.fetch_add(1, std::memory_order_relaxed);
+        s.usedFrames.fetch_add(1, std::memory_order_relaxed);
+    }
+    else {
+        s.policy->touched(frameIndex);
+    }
+
+    if (writing) s.frames[frameIndex].dirty = true;
+    return frameIndex * s.frameSize + address % s.frameSize;
+}
+
+}
+
+void MemoryManager::configure(const Config& config) {
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.mtx);
+
+    s.tables.clear();
+    s.store.close();
+    s.policy.reset();
+    s.usedFrames = 0;
+    s.pageIns = 0;
+    s.pageOuts = 0;
+    s.enabled = config.maxOverallMem > 0;
+    s.policyName = config.pageReplacement;
+    if (!s.enabled) {
+        s.physical.clear();
+        s.frames.clear();
+        s.freeFrames.clear();
+        return;
+    }
+
+    s.frameSize = static_cast<size_t>(std::max(config.memPerFrame, 4));
+    s.addressLimit = static_cast<uint32_t>(std::max(config.memPerProc, 4));
+    s.pagesPerProcess = (s.addressLimit + s.frameSize - 1) / s.frameSize;
+
+    size_t frameCount = std::max<size_t>(1, static_cast<size_t>(config.maxOverallMem) / s.frameSize);
+    s.physical.assign(frameCount * s.frameSize, 0);
+    s.frames.assign(frameCount, Frame());
+    s.freeFrames.clear();
+    for (size_t i = frameCount; i-- > 0;) s.freeFrames.push_back(static_cast<int>(i));
+
+    if (config.pageReplacement == "clock") s.policy.reset(new ClockPolicy(frameCount));
+    else s.policy.reset(new QueuePolicy(frameCount, config.pageReplacement == "lru"));
+
+    if (!s.store.open(config.backingStoreFile, s.frameSize)) {
+        s.enabled = false;
+        throw std::runtime_error("Could not open backing store " + config.backingStoreFile + ".");
+    }
+}
+
+void MemoryManager::shutdown() {
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.mtx);
+    s.enabled = false;
+    s.tables.clear();
+    s.store.close();
+}
+
+bool MemoryManager::enabled() {
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.mtx);
+    return s.enabled;
+}
+
+std::shared_ptr<MemoryManager::PageStats> MemoryManager::attach(int processId) {
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.mtx);
+    if (!s.enabled) return nullptr;
+    return tableFor(s, processId).stats;
+}
+
+void MemoryManager::release(int processId) {
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.mtx);
+    auto it = s.tables.find(processId);
+    if (it == s.tables.end()) return;
+
+    PageTable& table = it->second;
+    for (int frameIndex : table.frameOf) {
+        if (frameIndex < 0) continue;
+        s.policy->freed(frameIndex);
+        s.frames[frameIndex] = Frame();
+        s.freeFrames.push_back(frameIndex);
+        s.usedFrames.fetch_sub(1, std::memory_order_relaxed);
+    }
+    for (int64_t slot : table.backingSlot) {
+        if (slot >= 0) s.store.release(slot);
+    }
+    table.stats->residentPages.store(0, std::memory_order_relaxed);
+    s.tables.erase(it);
+}
+
+int32_t MemoryManager::read(int processId, uint32_t address) {
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.mtx);
+    int32_t value;
+    std::memcpy(&value, &s.physical[resolve(s, processId, address, false)], sizeof(value));
+    return value;
+}
+
+void MemoryManager::write(int processId, uint32_t address, int32_t value) {
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.mtx);
+    std::memcpy(&s.physical[resolve(s, processId, address, true)], &value, sizeof(value));
+}
+
+MemoryManager::Summary MemoryManager::summary() {
+    State& s = state();
+    Summary result;
+    {
+        std::lock_guard<std::mutex> lock(s.mtx);
+        result.enabled = s.enabled;
+        result.policy = s.policyName;
+        result.frameSize = s.frameSize;
+        result.totalFrames = s.frames.size();
+    }
+    result.usedFrames = s.usedFrames.load(std::memory_order_relaxed);
+    result.pageIns = s.pageIns.load(std::memory_order_relaxed);
+    result.pageOuts = s.pageOuts.load(std::memory_order_relaxed);
+    return result;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "Config.h"
+
+// Emulated physical memory with demand paging.
+//
+// Every process has a virtual address space of mem-per-proc bytes split
+// into mem-per-frame pages. Physical memory holds max-overall-mem bytes of
+// frames; a page is loaded into a frame on first access and evicted by the
+// configured replacement policy (fifo, lru or clock) to a memory-mapped
+// backing store file. Variables live in the process's data pages, four
+// bytes per slot. Paging is disabled when max-overall-mem is 0.
+class MemoryManager {
+public:
+    // Per-process counters, updated under the manager lock and readable
+    // without it
+    struct PageStats {
+        std::atomic<uint64_t> pageIns{ 0 };
+        std::atomic<uint64_t> pageOuts{ 0 };
+        std::atomic<uint32_t> residentPages{ 0 };
+    };
+
+    struct Summary {
+        bool enabled = false;
+        std::string policy;
+        size_t frameSize = 0;
+        size_t totalFrames = 0;
+        size_t usedFrames = 0;
+        uint64_t pageIns = 0;
+        uint64_t pageOuts = 0;
+    };
+
+    // (Re)initializes from config; drops every page table and frame
+    static void configure(const Config& config);
+    static void shutdown();
+    static bool enabled();
+
+    // Creates the page table for `processId`; returns null when disabled
+    static std::shared_ptr<PageStats> attach(int processId);
+    // Frees the process's frames and backing store slots
+    static void release(int processId);
+
+    // Throws std::out_of_range on an access outside mem-per-proc
+    static int32_t read(int processId, uint32_t address);
+    static void write(int processId, uint32_t address, int32_t value);
+
+    static Summary summary();
+};
@@ -1,15 +1,19 @@
 #include "ProcessManager.h"
 #include "Scheduler.h"
+#include "MemoryManager.h"
+#include "LatencyHistogram.h"
+#include "Random.h"
+#include <atomic>
 #include <iostream>
 #include <fstream>
 #include <iomanip>
+#include <sstream>
 #include <unordered_set>
 #include <mutex>
 #include <functional>
-int globalProcessId = 1;
+std::atomic<int> globalProcessId{ 1 };
 
-std::map<std::string, std::shared_ptr<Screen>> ProcessManager::processes;
-std::mutex ProcessManager::processMutex;
+ProcessTable ProcessManager::processTable;
 Scheduler* ProcessManager::scheduler = nullptr;
 
 void ProcessManager::setScheduler(Scheduler* sched) {
@@ -17,210 +21,217 @@ void ProcessManager::setScheduler(Scheduler* sched) {
 }
 
 void ProcessManager::createAndAttach(const std::string& name, const Config& config) {
-    std::vector<Instruction> instructions;
-    int numInstructions = rand() % (config.maxIns - config.minIns + 1) + config.minIns;
-
-    std::vector<std::string> variables = { "x", "y", "z", "a", "b", "c" };
-    std::unordered_set<std::string> declaredVariables;
-
-    auto generateSimpleInstruction = [&](InstructionType type) -> Instruction {
-        Instruction instr;
-        instr.type = type;
-
-        switch (type) {
-        case InstructionType::DECLARE: {
-            std::string var = variables[rand() % variables.size()];
-            int value = rand() % 20 + 1;
-            instr.args = { var, std::to_string(value) };
-            declaredVariables.insert(var);
-            break;
-        }
-        case InstructionType::ADD:
-        case InstructionType::SUBTRACT: {
-            std::string dest = variables[rand() % variables.size()];
-            std::string op1 = variables[rand() % variables.size()];
-            std::string op2 = variables[rand() % variables.size()];
-            instr.args = { dest, op1, op2 };
-            declaredVariables.insert(dest);
-            break;
-        }
-        case InstructionType::PRINT: {
-            instr.args = { "Hello from " + name };
-            break;
-        }
-        case InstructionType::SLEEP: {
-            instr.args = { std::to_string(rand() % 3 + 1) };
-            break;
-        }
-        default:
-            break;
-        }
-
-        return instr;
-        };
-
-    for (int i = 0; i < numInstructions; ++i) {
-        int choice = rand() % 5;  // only 0 to 4
-        InstructionType type = static_cast<InstructionType>(choice);
-        instructions.push_back(generateSimpleInstruction(type));
-    }
+    int processId = globalProcessId++;
+    Xoshiro256 rng = Random::forProcess(config.seed, processId);
+    int numInstructions = rng.range(config.minIns, config.maxIns);
 
-    auto screen = std::make_shared<Screen>(name, instructions, globalProcessId++);
+    // Same generator as scheduler-created processes
+    auto screen = std::make_shared<Screen>(name, std::vector<Instruction>(), processId);
+    screen->generateDummyInstructions(config, numInstructions, rng);
     registerProcess(screen);
 }
 
 
 void ProcessManager::resumeScreen(const std::string& name) {
-    std::lock_guard<std::mutex> lock(processMutex);
-    auto it = processes.find(name);
-    if (it != processes.end()) {
-        it->second->showScreen();
+    std::shared_ptr<Screen> screen = getProcess(name);
+    if (screen) {
+        screen->showScreen();
     }
     else {
         std::cout << "Process \"" << name << "\" not found.\n";
     }
 }
 
-void ProcessManager::listScreens(const Config& config) {
-    std::lock_guard<std::mutex> lock(processMutex);
-    std::cout << "\n----------------------------------------\n";
-
+void ProcessManager::writeReport(std::ostream& out, int totalCores) {
+    struct Row {
+        const ProcessTable::Record* entry;
+        ScreenState state;
+    };
+
+    // One pass over the table; each row's state is a single atomic load,
+    // so no process or scheduler lock is taken
+    std::vector<Row> rows;
+    rows.reserve(processTable.size());
+    processTable.forEach([&rows](const ProcessTable::Record& record) {
+        rows.push_back({ &record, record.screen->loadState() });
+    });
+
+    // Ready processes last seen on a core removed by cpu-set do not count
     std::unordered_set<int> activeCoreIds;
-    for (const auto& pair : processes) {
-        const std::shared_ptr<Screen>& proc = pair.second;
-        if (!proc->isFinished() && proc->getCoreAssigned() != -1) {
-            activeCoreIds.insert(proc->getCoreAssigned());
+    for (const auto& row : rows) {
+        ProcessStatus status = row.state.status;
+        if (status != ProcessStatus::FINISHED && status != ProcessStatus::WAITING
+            && row.state.coreAssigned != -1 && row.state.coreAssigned < totalCores) {
+            activeCoreIds.insert(row.state.coreAssigned);
         }
     }
 
-
-    int totalCores = config.numCpu;
     int activeCores = static_cast<int>(activeCoreIds.size());
     int coresAvailable = std::max(0, totalCores - activeCores);
     double utilization = (static_cast<double>(activeCores) / totalCores) * 100.0;
 
-    std::cout << "CPU Stats:\n"
+    out << "CPU Stats:\n"
         << "Cores Used:      " << activeCores << " / " << totalCores << "\n"
         << "Cores Available: " << coresAvailable << "\n"
         << "CPU Utilization: " << std::fixed << std::setprecision(2) << utilization << "%\n"
         << "\n----------------------------------------\n";
 
-    std::cout << "\nRunning Processes:\n";
-    int cntRunning = 0;
-    for (const auto& pair : processes) {
-        const std::string& name = pair.first;
-        const std::shared_ptr<Screen>& proc = pair.second;
+    MemoryManager::Summary memory = MemoryManager::summary();
+    if (memory.enabled) {
+        size_t usedBytes = memory.usedFrames * memory.frameSize;
+        size_t totalBytes = memory.totalFrames * memory.frameSize;
+        out << "\nMemory Stats (" << memory.policy << "):\n"
+            << "Memory Used:     " << usedBytes << " / " << totalBytes << " bytes ("
+            << memory.usedFrames << " / " << memory.totalFrames << " frames)\n"
+            << "Pages In:        " << memory.pageIns << "\n"
+            << "Pages Out:       " << memory.pageOuts << "\n"
+            << "\n----------------------------------------\n";
+    }
+    // Resident pages and page-in/out counts, appended to a process's row
+    auto paging = [&memory](const Row& row) {
+        const MemoryManager::PageStats* stats = row.entry->screen->getPageStats();
+        if (!memory.enabled || !stats) return std::string();
+        return "   Pages: " + std::to_string(stats->residentPages.load(std::memory_order_relaxed))
+            + " (in " + std::to_string(stats->pageIns.load(std::memory_order_relaxed))
+            + ", out " + std::to_string(stats->pageOuts.load(std::memory_order_relaxed)) + ")";
+    };
+    // CPU and ready-queue time so far; finished rows add response and turnaround
+    const bool virtualClock = config.clockMode == "virtual";
+    auto timing = [virtualClock](const Row& row) {
+        ProcessTimes t = row.entry->screen->loadTimes();
+        if (!t.started) return std::string();
+        std::string text = "   CPU " + LatencyHistogram::format(t.cpuTime, virtualClock)
+            + ", wait " + LatencyHistogram::format(t.readyWait, virtualClock);
+        if (t.completed) {
+            text += ", response " + LatencyHistogram::format(t.firstRun - t.arrival, virtualClock)
+                + ", turnaround " + LatencyHistogram::format(t.finish - t.arrival, virtualClock);
+        }
+        return text;
+    };
 
-        if (proc->getStatus() == ProcessStatus::RUNNING) {
+    out << "\nRunning Processes:\n";
+    int cntRunning = 0;
+    for (const auto& row : rows) {
+        if (row.state.status == ProcessStatus::RUNNING) {
             cntRunning++;
-            std::cout << std::setw(15) << std::left << ("- " + name)
-                << std::setw(22) << ("(" + proc->getCreationTimestamp() + ")")
-                << "Core: " << std::setw(3) << proc->getCoreAssigned()
-                << "   " << proc->getCurrentInstruction()
-                << " / " << proc->getTotalInstructions() << "\n";
+            out << std::setw(15) << std::left << ("- " + row.entry->name)
+                << std::setw(22) << ("(" + row.entry->creationTimestamp + ")")
+                << "Core: " << std::setw(3) << row.state.coreAssigned
+                << "   " << row.state.instructionPointer + 1
+                << " / " << row.state.totalInstructions << paging(row) << timing(row) << "\n";
         }
     }
+    if (cntRunning == 0) out << "No running processes.\n";
+
+    out << "\nSleeping Processes:\n";
+    int cntSleeping = 0;
+    for (const auto& row : rows) {
+        if (row.state.status == ProcessStatus::WAITING) {
+            cntSleeping++;
+            out << std::setw(15) << std::left << ("- " + row.entry->name)
+                << std::setw(22) << ("(" + row.entry->creationTimestamp + ")")
+                << "Waiting    " << row.state.instructionPointer + 1
+                << " / " << row.state.totalInstructions << paging(row) << timing(row) << "\n";
+        }
+    }
+    if (cntSleeping == 0) out << "No sleeping processes.\n";
 
-    if (cntRunning == 0) std::cout << "No running processes.\n";
-
-    std::cout << "\nFinished Processes:\n";
+    out << "\nFinished Processes:\n";
     int cntFinished = 0;
-    for (const auto& pair : processes) {
-        const std::string& name = pair.first;
-        const std::shared_ptr<Screen>& proc = pair.second;
-
-        if (proc->isFinished()) {
+    for (const auto& row : rows) {
+        if (row.state.status == ProcessStatus::FINISHED) {
             cntFinished++;
-            std::cout << std::setw(15) << std::left << ("- " + name)
-                << std::setw(22) << ("(" + proc->getCreationTimestamp() + ")")
+            out << std::setw(15) << std::left << ("- " + row.entry->name)
+                << std::setw(22) << ("(" + row.entry->creationTimestamp + ")")
                 << "Finished   "
-                << proc->getTotalInstructions() << " / " << proc->getTotalInstructions() << "\n";
+                << row.state.totalInstructions << " / " << row.state.totalInstructions << paging(row) << timing(row) << "\n";
         }
     }
-    if (cntFinished == 0) std::cout << "No finished processes.\n";
+    if (cntFinished == 0) out << "No finished processes.\n";
 
-    std::cout << "----------------------------------------\n\n";
+    out << "----------------------------------------\n\n";
+}
+
+void ProcessManager::listScreens(const Config& config) {
+    // Format into a buffer first so a slow terminal never holds anything up
+    std::ostringstream buffer;
+    buffer << "\n----------------------------------------\n";
+    writeReport(buffer, config.numCpu);
+    std::cout << buffer.str();
 }
 
 std::vector<std::shared_ptr<Screen>> ProcessManager::getAllProcesses() {
-    std::lock_guard<std::mutex> lock(processMutex);
     std::vector<std::shared_ptr<Screen>> all;
-    for (const auto& p : processes) {
-        all.push_back(p.second);
-    }
+    all.reserve(processTable.size());
+    processTable.forEach([&all](const ProcessTable::Record& record) {
+        all.push_back(record.screen);
+    });
     return all;
 }
 
-void ProcessManager::generateReport() {
+void ProcessManager::forEachProcess(const std::function<void(const std::shared_ptr<Screen>&)>& visit) {
+    processTable.forEach([&visit](const ProcessTable::Record& record) {
+        visit(record.screen);
+    });
+}
+
+void ProcessManager::generateReport(const Scheduler* sched) {
     std::ofstream file("csopesy-log.txt");
     if (!file.is_open()) {
         std::cerr << "Failed to open csopesy-log.txt for writing.\n";
         return;
     }
 
-
-    std::unordered_set<int> activeCoreIds;
-    for (const auto& pair : processes) {
-        const std::shared_ptr<Screen>& proc = pair.second;
-        if (!proc->isFinished() && proc->getCoreAssigned() != -1) {
-            activeCoreIds.insert(proc->getCoreAssigned());
-        }
+    std::ostringstream buffer;
+    writeReport(buffer, config.numCpu);
+    writeLatencyHistograms(buffer);
+    if (sched) {
+        sched->printCounters(buffer);
+        buffer << "----------------------------------------\n";
     }
+    file << buffer.str();
 
-    int totalCores = config.numCpu;
-    int activeCores = static_cast<int>(activeCoreIds.size());
-    int coresAvailable = std::max(0, totalCores - activeCores);
-    double utilization = (static_cast<double>(activeCores) / totalCores) * 100.0;
-
-    file << "CPU Stats:\n"
-        << "Cores Used:      " << activeCores << " / " << totalCores << "\n"
-        << "Cores Available: " << coresAvailable << "\n"
-        << "CPU Utilization: " << std::fixed << std::setprecision(2) << utilization << "%\n"
-        << "\n----------------------------------------\n";
-
-    file << "\nRunning Processes:\n";
-    int cntRunning = 0;
-    for (const auto& pair : processes) {
-        const std::string& name = pair.first;
-        const std::shared_ptr<Screen>& proc = pair.second;
-
-        if (proc->getStatus() == ProcessStatus::RUNNING) {
-            cntRunning++;
-            file << std::setw(15) << std::left << ("- " + name)
-                << std::setw(22) << ("(" + proc->getCreationTimestamp() + ")")
-                << "Core: " << std::setw(3) << proc->getCoreAssigned()
-                << "   " << proc->getCurrentInstruction()
-                << " / " << proc->getTotalInstructions() << "\n";
-        }
-    }
-    if (cntRunning == 0) file << "No running processes.\n";
-
-    file << "\nFinished Processes:\n";
-    int cntFinished = 0;
-    for (const auto& pair : processes) {
-        const std::string& name = pair.first;
-        const std::shared_ptr<Screen>& proc = pair.second;
+    std::cout << "Report saved to csopesy-log.txt\n";
+}
 
-        if (proc->isFinished()) {
-            cntFinished++;
-            file << std::setw(15) << std::left << ("- " + name)
-                << std::setw(22) << ("(" + proc->getCreationTimestamp() + ")")
-                << "Finished   "
-                << proc->getTotalInstructions() << " / " << proc->getTotalInstructions() << "\n";
+void ProcessManager::writeLatencyHistograms(std::ostream& out) {
+    LatencyHistogram waiting, response, turnaround, cpu;
+    processTable.forEach([&](const ProcessTable::Record& record) {
+        ProcessTimes t = record.screen->loadTimes();
+        if (t.started) response.add(t.firstRun - t.arrival);
+        if (t.completed) {
+            waiting.add(t.readyWait);
+            turnaround.add(t.finish - t.arrival);
+            cpu.add(t.cpuTime);
         }
-    }
-    if (cntFinished == 0) file << "No finished processes.\n";
-
-    file << "----------------------------------------\n\n";
+    });
+
+    const bool virtualClock = config.clockMode == "virtual";
+    out << "Latency (" << (virtualClock ? "virtual ticks" : "monotonic clock") << "):\n";
+    response.print(out, "Response (arrival to first run)", virtualClock);
+    waiting.print(out, "Waiting (time in ready queues, finished processes)", virtualClock);
+    turnaround.print(out, "Turnaround (arrival to completion)", virtualClock);
+    cpu.print(out, "CPU Time (finished processes)", virtualClock);
+    out << "----------------------------------------\n";
+}
 
-    std::cout << "Report saved to csopesy-log.txt\n";
+void ProcessManager::printMemoryStats(std::ostream& out, const Config& config) {
+    size_t count = 0, bytes = 0;
+    processTable.forEach([&count, &bytes](const ProcessTable::Record& record) {
+        ++count;
+        bytes += record.screen->memoryFootprint();
+    });
+
+    out << "Memory:\n"
+        << "Program Mode:    " << config.programMode << "\n"
+        << "Processes:       " << count << "\n"
+        << "Process Memory:  " << std::fixed << std::setprecision(1) << bytes / 1024.0 << " KiB ("
+        << (count ? bytes / count : 0) << " bytes/process)\n";
 }
 
 void ProcessManager::registerProcess(std::shared_ptr<Screen> process) {
-    {
-        std::lock_guard<std::mutex> lock(processMutex);
-        processes[process->getName()] = process;
-    }
+    process->attachMemory();
+    processTable.insert(process);
 
     if (scheduler) {
         scheduler->addProcess(process);
@@ -228,12 +239,17 @@ void ProcessManager::registerProcess(std::shared_ptr<Screen> process) {
 }
 
 bool ProcessManager::hasProcess(const std::string& name) {
-    std::lock_guard<std::mutex> lock(processMutex);
-    return processes.find(name) != processes.end();
+    return processTable.find(name) != nullptr;
+}
+
+void ProcessManager::reset() {
+    processTable.clear();
 }
 
 std::shared_ptr<Screen> ProcessManager::getProcess(const std::string& name) {
-    std::lock_guard<std::mutex> lock(processMutex);
-    auto it = processes.find(name);
-    return it != processes.end() ? it->second : nullptr;
+    return processTable.find(name);
+}
+
+std::shared_ptr<Screen> ProcessManager::getProcess(int processId) {
+    return processTable.find(processId);
 }
@@ -1,12 +1,12 @@
 #pragma once
 
-#include <map>
+#include <functional>
 #include <memory>
-#include <mutex>
 #include <string>
 
 #include "Screen.h"
 #include "Config.h"
+#include "ProcessTable.h"
 
 class Scheduler;
 
@@ -16,15 +16,29 @@ public:
     static void createAndAttach(const std::string& name, const Config& config);
     static void resumeScreen(const std::string& name);
     static void listScreens(const Config& config);
-    static void generateReport();
+    // Writes csopesy-log.txt; includes per-core counters when `sched` is set
+    static void generateReport(const Scheduler* sched = nullptr);
+    // Process count and approximate memory held by processes and programs
+    static void printMemoryStats(std::ostream& out, const Config& config);
     static void registerProcess(std::shared_ptr<Screen> process);
 
     static std::vector<std::shared_ptr<Screen>> getAllProcesses();
     static bool hasProcess(const std::string& name);
     static std::shared_ptr<Screen> getProcess(const std::string& name);
+    static std::shared_ptr<Screen> getProcess(int processId);
+
+    // Lock-free walk in PID order; avoids copying the whole table
+    static void forEachProcess(const std::function<void(const std::shared_ptr<Screen>&)>& visit);
+
+    // Drops every registered process; not safe while readers are listing
+    static void reset();
 
 private:
-    static std::map<std::string, std::shared_ptr<Screen>> processes;
-    static std::mutex processMutex;
+    // Lock-free listing shared by screen -ls and report-util
+    static void writeReport(std::ostream& out, int totalCores);
+    // Response, waiting, turnaround and CPU time histograms for report-util
+    static void writeLatencyHistograms(std::ostream& out);
+
+    static ProcessTable processTable;
     static Scheduler* scheduler;
 };
@@ -0,0 +1,177 @@
+#include "ProcessTable.h"
+#include "Screen.h"
+#include <algorithm>
+#include <stdexcept>
+
+ProcessTable::ProcessTable()
+    : highWater(0), liveCount(0)
+{
+    for (auto& segment : segments) segment.store(nullptr, std::memory_order_relaxed);
+}
+
+ProcessTable::~ProcessTable() {
+    clear();
+    for (auto& segment : segments) delete[] segment.load(std::memory_order_relaxed);
+}
+
+ProcessTable::Slot* ProcessTable::slotFor(int processId) const {
+    if (processId < 0) return nullptr;
+    size_t index = static_cast<size_t>(processId);
+    if ((index >> SEGMENT_BITS) >= MAX_SEGMENTS) return nullptr;
+
+    Slot* segment = segments[index >> SEGMENT_BITS].load(std::memory_order_acquire);
+    return segment ? &segment[index & (SEGMENT_SIZE - 1)] : nullptr;
+}
+
+ProcessTable::Slot& ProcessTable::ensureSlot(int processId) {
+    if (processId < 0 || (static_cast<size_t>(processId) >> SEGMENT_BITS) >= MAX_SEGMENTS) {
+        throw std::out_of_range("Process ID " + std::to_string(processId) + " is outside the process table.");
+    }
+
+    size_t index = static_cast<size_t>(processId);
+    std::atomic<Slot*>& segmentRef = segments[index >> SEGMENT_BITS];
+    Slot* segment = segmentRef.load(std::memory_order_acquire);
+    if (!segment) {
+        // Racing writers may both allocate; the loser frees its copy
+        Slot* fresh = new Slot[SEGMENT_SIZE];
+        if (segmentRef.compare_exchange_strong(segment, fresh, std::memory_order_acq_rel)) {
+            segment = fresh;
+        }
+        else {
+            delete[] fresh;
+        }
+    }
+    return segment[index & (SEGMENT_SIZE - 1)];
+}
+
+ProcessTable::Shard& ProcessTable::shardFor(const std::string& name) const {
+    return shards[std::hash<std::string>()(name) % SHARD_COUNT];
+}
+
+void ProcessTable::retire(const Record* record) {
+    std::lock_guard<std::mutex> lock(retiredMutex);
+    retired.push_back(record);
+}
+
+// Empties the slot if it still holds expected
+void ProcessTable::vacate(int processId, const Record* expected) {
+    Slot* slot = slotFor(processId);
+    if (!slot) return;
+
+    if (slot->record.compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel)) {
+        slot->generation.fetch_add(1, std::memory_order_release);
+        liveCount.fetch_sub(1, std::memory_order_relaxed);
+        retire(expected);
+    }
+}
+
+void ProcessTable::insert(const std::shared_ptr<Screen>& screen) {
+    Record* record = new Record{ screen->getProcessId(), screen->getName(), screen->getCreationTimestamp(), screen };
+    Slot& slot = ensureSlot(record->processId);
+
+    // The name index decides which PID owns a name; the shard lock keeps
+    // two registrations of the same name from both surviving
+    int replacedPid = -1;
+    {
+        Shard& shard = shardFor(record->name);
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        auto it = shard.pids.find(record->name);
+        if (it != shard.pids.end()) {
+            if (it->second != record->processId) replacedPid = it->second;
+            it->second = record->processId;
+        }
+        else {
+            shard.pids.emplace(record->name, record->processId);
+        }
+    }
+
+    if (replacedPid != -1) {
+        Slot* old = slotFor(replacedPid);
+        const Record* oldRecord = old ? old->record.load(std::memory_order_acquire) : nullptr;
+        if (oldRecord && oldRecord->name == record->name) vacate(replacedPid, oldRecord);
+    }
+
+    const Record* previous = slot.record.exchange(record, std::memory_order_acq_rel);
+    slot.generation.fetch_add(1, std::memory_order_release);
+    if (previous) {
+        // Same PID reused under a different name: drop the stale name
+        if (previous->name != record->name) {
+            Shard& shard = shardFor(previous->name);
+            std::lock_guard<std::mutex> lock(shard.mtx);
+            auto it = shard.pids.find(previous->name);
+            if (it != shard.pids.end() && it->second == record->processId) shard.pids.erase(it);
+        }
+        retire(previous);
+    }
+    else {
+        liveCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    int next = record->processId + 1;
+    int seen = highWater.load(std::memory_order_relaxed);
+    while (seen < next && !highWater.compare_exchange_weak(seen, next, std::memory_order_release)) {
+    }
+}
+
+std::shared_ptr<Screen> ProcessTable::find(int processId) const {
+    Slot* slot = slotFor(processId);
+    const Record* record = slot ? slot->record.load(std::memory_order_acquire) : nullptr;
+    return record ? record->screen : nullptr;
+}
+
+std::shared_ptr<Screen> ProcessTable::find(const std::string& name) const {
+    int processId;
+    {
+        Shard& shard = shardFor(name);
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        auto it = shard.pids.find(name);
+        if (it == shard.pids.end()) return nullptr;
+        processId = it->second;
+    }
+
+    Slot* slot = slotFor(processId);
+    const Record* record = slot ? slot->record.load(std::memory_order_acquire) : nullptr;
+    return record && record->name == name ? record->screen : nullptr;
+}
+
+uint32_t ProcessTable::generation(int processId) const {
+    Slot* slot = slotFor(processId);
+    return slot ? slot->generation.load(std::memory_order_acquire) : 0;
+}
+
+void ProcessTable::forEach(const std::function<void(const Record&)>& visit) const {
+    int end = highWater.load(std::memory_order_acquire);
+    for (int base = 0; base < end; base += static_cast<int>(SEGMENT_SIZE)) {
+        Slot* segment = segments[static_cast<size_t>(base) >> SEGMENT_BITS].load(std::memory_order_acquire);
+        if (!segment) continue;
+
+        int count = std::min(static_cast<int>(SEGMENT_SIZE), end - base);
+        for (int i = 0; i < count; ++i) {
+            const Record* record = segment[i].record.load(std::memory_order_acquire);
+            if (record) visit(*record);
+        }
+    }
+}
+
+void ProcessTable::clear() {
+    int end = highWater.exchange(0, std::memory_order_acq_rel);
+    for (int pid = 0; pid < end; ++pid) {
+        Slot* slot = slotFor(pid);
+        if (!slot) continue;
+        const Record* record = slot->record.exchange(nullptr, std::memory_order_acq_rel);
+        if (record) {
+            slot->generation.fetch_add(1, std::memory_order_release);
+            delete record;
+        }
+    }
+    liveCount.store(0, std::memory_order_relaxed);
+
+    for (auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        shard.pids.clear();
+    }
+
+    std::lock_guard<std::mutex> lock(retiredMutex);
+    for (const Record* record : retired) delete record;
+    retired.clear();
+}
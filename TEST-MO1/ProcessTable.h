@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Screen;
+
+// Process table indexed by PID.
+//
+// Slots live in fixed-size segments that are allocated on first use and
+// never move, so slot PID is found with two array lookups. Each slot holds
+// an immutable record and a generation counter that is bumped whenever the
+// slot is filled or cleared; a (pid, generation) pair therefore names one
+// particular occupant. Readers never lock: they load the record pointer and
+// read it. Replaced records are retired and only freed by clear().
+//
+// Names are resolved through a sharded hash index so lookups from the CLI,
+// generator and workers only contend when they hash to the same shard.
+class ProcessTable {
+public:
+    struct Record {
+        int processId;
+        std::string name;
+        std::string creationTimestamp;
+        std::shared_ptr<Screen> screen;
+    };
+
+    ProcessTable();
+    ~ProcessTable();
+
+    // Fills the slot for screen's PID; a previous process with the same
+    // name is removed from the table
+    void insert(const std::shared_ptr<Screen>& screen);
+
+    std::shared_ptr<Screen> find(int processId) const;
+    std::shared_ptr<Screen> find(const std::string& name) const;
+    uint32_t generation(int processId) const;
+
+    // Visits every live record in PID order without taking any lock
+    void forEach(const std::function<void(const Record&)>& visit) const;
+    size_t size() const { return liveCount.load(std::memory_order_relaxed); }
+
+    // Not safe against concurrent readers; only used when the table is idle
+    void clear();
+
+private:
+    struct Slot {
+        std::atomic<const Record*> record{ nullptr };
+        std::atomic<uint32_t> generation{ 0 };
+    };
+
+    struct Shard {
+        std::mutex mtx;
+        std::unordered_map<std::string, int> pids;
+    };
+
+    static constexpr size_t SEGMENT_BITS = 14;
+    static constexpr size_t SEGMENT_SIZE = size_t(1) << SEGMENT_BITS;
+    static constexpr size_t MAX_SEGMENTS = 1024;   // 16M PIDs
+    static constexpr size_t SHARD_COUNT = 64;
+
+    Slot* slotFor(int processId) const;
+    Slot& ensureSlot(int processId);
+    void vacate(int processId, const Record* expected);
+    void retire(const Record* record);
+    Shard& shardFor(const std::string& name) const;
+
+    mutable std::atomic<Slot*> segments[MAX_SEGMENTS];
+    std::atomic<int> highWater;   // one past the largest PID ever filled
+    std::atomic<size_t> liveCount;
+
+    mutable Shard shards[SHARD_COUNT];
+
+    std::mutex retiredMutex;
+    std::vector<const Record*> retired;
+};
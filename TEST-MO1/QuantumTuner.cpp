@@ -0,0 +1,58 @@
+#include "QuantumTuner.h"
+#include <algorithm>
+#include <cmath>
+
+QuantumTuner::QuantumTuner(int initial, int minQuantum_, int maxQuantum_)
+    : minQuantum(std::max(minQuantum_, 1)),
+    maxQuantum(std::max(maxQuantum_, std::max(minQuantum_, 1)))
+{
+    int start = std::min(std::max(initial, minQuantum), maxQuantum);
+    quantum.store(start);
+    smoothed = start;
+}
+
+QuantumTuner::Decision QuantumTuner::adapt(const Sample& sample) {
+    long long instructions = sample.instructions - last.instructions;
+    long long bursts = sample.burstsEnded - last.burstsEnded;
+    long long dispatches = sample.dispatches - last.dispatches;
+    uint64_t busy = sample.busyTime - last.busyTime;
+    uint64_t overhead = sample.dispatchOverhead - last.dispatchOverhead;
+    last = sample;
+
+    Decision decision;
+    decision.time = sample.now;
+    decision.readyPerCore = static_cast<double>(sample.readyProcesses) / std::max(sample.cores, 1);
+
+    // Nothing ran this period: keep the current quantum
+    if (instructions <= 0) {
+        decision.quantum = current();
+        return decision;
+    }
+
+    decision.avgBurst = bursts > 0 ? static_cast<double>(instructions) / bursts : maxQuantum;
+    decision.timePerInstruction = static_cast<double>(busy) / instructions;
+    decision.overheadPerDispatch = dispatches > 0 ? static_cast<double>(overhead) / dispatches : 0.0;
+
+    double target = decision.avgBurst;
+    if (decision.readyPerCore > 1.0) {
+        target = std::min(target, maxQuantum / decision.readyPerCore);
+    }
+    if (decision.timePerInstruction > 0.0) {
+        target = std::max(target, decision.overheadPerDispatch / (0.1 * decision.timePerInstruction));
+    }
+    target = std::min(std::max(target, static_cast<double>(minQuantum)), static_cast<double>(maxQuantum));
+
+    smoothed = 0.5 * smoothed + 0.5 * target;
+    decision.quantum = std::min(std::max(static_cast<int>(std::lround(smoothed)), minQuantum), maxQuantum);
+    quantum.store(decision.quantum, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(historyMutex);
+    recent.push_back(decision);
+    if (recent.size() > HISTORY) recent.pop_front();
+    return decision;
+}
+
+std::vector<QuantumTuner::Decision> QuantumTuner::history() const {
+    std::lock_guard<std::mutex> lock(historyMutex);
+    return std::vector<Decision>(recent.begin(), recent.end());
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+// Adaptive round robin quantum.
+//
+// Every adapt() looks at how the scheduler's cumulative counters changed
+// since the previous call and picks a quantum that:
+//   - covers the average CPU burst (instructions between SLEEPs), so
+//     typical bursts finish in one slice,
+//   - shrinks as more processes wait per core, to bound response time,
+//   - stays long enough that dispatch overhead is at most 10% of a slice.
+// The result is smoothed and clamped to [min, max].
+class QuantumTuner {
+public:
+    // Cumulative counters; times are in scheduler clock units
+    struct Sample {
+        uint64_t now = 0;
+        long long instructions = 0;
+        long long burstsEnded = 0;     // SLEEPs plus finished processes
+        long long dispatches = 0;
+        uint64_t busyTime = 0;
+        uint64_t dispatchOverhead = 0;
+        int readyProcesses = 0;
+        int cores = 1;
+    };
+
+    struct Decision {
+        uint64_t time = 0;
+        int quantum = 0;
+        double avgBurst = 0.0;
+        double readyPerCore = 0.0;
+        double overheadPerDispatch = 0.0;
+        double timePerInstruction = 0.0;
+    };
+
+    QuantumTuner(int initial, int minQuantum, int maxQuantum);
+
+    int current() const { return quantum.load(std::memory_order_relaxed); }
+
+    // Not reentrant: one caller at a time
+    Decision adapt(const Sample& sample);
+
+    // Most recent decisions, oldest first
+    std::vector<Decision> history() const;
+
+private:
+    static constexpr size_t HISTORY = 32;
+
+    std::atomic<int> quantum;
+    int minQuantum;
+    int maxQuantum;
+    double smoothed;
+    Sample last;
+
+    mutable std::mutex historyMutex;
+    std::deque<Decision> recent;
+};
@@ -0,0 +1,67 @@
+#include "Random.h"
+
+#include <atomic>
+
+namespace {
+
+uint64_t splitmix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Domain tags keep thread streams apart from process streams
+const uint64_t THREAD_STREAM = 0x7468726561640000ULL;
+const uint64_t PROCESS_STREAM = 0x70726f6365737300ULL;
+
+uint64_t streamSeed(uint64_t seed, uint64_t domain, uint64_t index) {
+    uint64_t state = seed ^ domain;
+    uint64_t mixed = splitmix64(state);
+    state = mixed ^ (index * 0xD1B54A32D192ED03ULL);
+    return splitmix64(state);
+}
+
+struct State {
+    std::atomic<uint64_t> seed{ 1 };
+    std::atomic<uint64_t> generation{ 1 };
+    std::atomic<uint64_t> nextThread{ 0 };
+};
+
+State& state() {
+    static State s;
+    return s;
+}
+
+} // namespace
+
+Xoshiro256::Xoshiro256(uint64_t seed) {
+    for (uint64_t& word : s) word = splitmix64(seed);
+}
+
+void Random::seed(uint64_t seed) {
+    State& s = state();
+    s.seed.store(seed);
+    s.nextThread.store(0);
+    s.generation.fetch_add(1);
+}
+
+Xoshiro256& Random::local() {
+    struct ThreadGenerator {
+        uint64_t generation = 0;
+        Xoshiro256 gen;
+    };
+    thread_local ThreadGenerator local;
+
+    State& s = state();
+    uint64_t generation = s.generation.load(std::memory_order_acquire);
+    if (local.generation != generation) {
+        local.gen = Xoshiro256(streamSeed(s.seed.load(), THREAD_STREAM, s.nextThread.fetch_add(1)));
+        local.generation = generation;
+    }
+    return local.gen;
+}
+
+Xoshiro256 Random::forProcess(uint64_t seed, int processId) {
+    return Xoshiro256(streamSeed(seed, PROCESS_STREAM, static_cast<uint64_t>(processId)));
+}
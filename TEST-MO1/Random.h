@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+// xoshiro256** generator. Satisfies UniformRandomBitGenerator, so it can
+// also drive <random> distributions. Not thread-safe: use one per thread
+// (Random::local) or one per process (Random::forProcess).
+class Xoshiro256 {
+public:
+    using result_type = uint64_t;
+
+    // The 256-bit state is expanded from `seed` with splitmix64
+    explicit Xoshiro256(uint64_t seed = 0);
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() {
+        const uint64_t result = rotl(s[1] * 5, 7) * 9;
+        const uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+
+    // Value in [0, bound) by multiply-shift, without a division; bound > 0
+    uint32_t below(uint32_t bound) {
+        return static_cast<uint32_t>(((*this)() >> 32) * bound >> 32);
+    }
+
+    // Value in [lo, hi]; lo <= hi
+    int range(int lo, int hi) {
+        return lo + static_cast<int>(below(static_cast<uint32_t>(hi - lo) + 1));
+    }
+
+private:
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+    uint64_t s[4];
+};
+
+// Replaces the global rand(): no shared state between threads, and every
+// stream derives from the config `seed`.
+class Random {
+public:
+    // Reseeds the per-thread generators; each thread picks up the new
+    // seed on its next call to local()
+    static void seed(uint64_t seed);
+
+    // Generator of the calling thread. Threads get distinct streams in the
+    // order they first draw, so only single-threaded use is reproducible.
+    static Xoshiro256& local();
+
+    // Stream owned by one process: the same seed and process id always
+    // give the same sequence, whichever thread creates the process
+    static Xoshiro256 forProcess(uint64_t seed, int processId);
+};
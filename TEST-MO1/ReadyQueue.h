@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+class Screen;
+
+// A ready queue shared by every core, used by the policies that order work
+// globally (mlfq, sjf, srtf) instead of the per-core run queues.
+// Not thread-safe: the scheduler serializes access.
+class ReadyQueue {
+public:
+    // Why a process is being queued; policies may reprioritize on it
+    enum class Reason { ARRIVED, PREEMPTED, WOKE };
+
+    virtual ~ReadyQueue() = default;
+
+    virtual void push(const std::shared_ptr<Screen>& process, Reason reason, uint64_t now) = 0;
+
+    // Next process to run, or null. `quantum` may be lowered or raised for
+    // this dispatch; it comes in as quantum-cycles.
+    virtual std::shared_ptr<Screen> pop(uint64_t now, int& quantum) = 0;
+
+    virtual size_t size() const = 0;
+    bool empty() const { return size() == 0; }
+};
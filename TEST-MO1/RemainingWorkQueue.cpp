@@ -0,0 +1,38 @@
+#include "RemainingWorkQueue.h"
+#include "Screen.h"
+#include <algorithm>
+#include <cstdint>
+
+void RemainingWorkQueue::push(const std::shared_ptr<Screen>& process, Reason, uint64_t now) {
+    size_t total = process->getTotalInstructions();
+    size_t done = process->getCurrentInstruction();
+    heap.push_back(Entry{ total > done ? total - done : 0, nextSequence++, now, process });
+    std::push_heap(heap.begin(), heap.end(), RunsLater());
+}
+
+std::shared_ptr<Screen> RemainingWorkQueue::pop(uint64_t now, int&) {
+    if (heap.empty()) return nullptr;
+
+    std::pop_heap(heap.begin(), heap.end(), RunsLater());
+    Entry entry = std::move(heap.back());
+    heap.pop_back();
+
+    uint64_t wait = now > entry.enqueuedAt ? now - entry.enqueuedAt : 0;
+    ++dispatches;
+    totalWait += wait;
+    maxWait = std::max(maxWait, wait);
+    return entry.process;
+}
+
+size_t RemainingWorkQueue::shortestRemaining() const {
+    return heap.empty() ? SIZE_MAX : heap.front().remaining;
+}
+
+RemainingWorkQueue::Stats RemainingWorkQueue::stats() const {
+    Stats s;
+    s.queued = heap.size();
+    s.dispatches = dispatches;
+    s.totalWait = totalWait;
+    s.maxWait = maxWait;
+    return s;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "ReadyQueue.h"
+
+// Binary min-heap keyed on remaining instructions, for the sjf and srtf
+// schedulers. The key is taken when a process is queued (it cannot change
+// while the process waits), so arrivals cost O(log n) with no rescans.
+// Equal keys run in arrival order.
+class RemainingWorkQueue : public ReadyQueue {
+public:
+    struct Stats {
+        size_t queued = 0;
+        long long dispatches = 0;
+        uint64_t totalWait = 0;    // enqueue to dispatch, in clock units
+        uint64_t maxWait = 0;
+    };
+
+    void push(const std::shared_ptr<Screen>& process, Reason reason, uint64_t now) override;
+    std::shared_ptr<Screen> pop(uint64_t now, int& quantum) override;
+    size_t size() const override { return heap.size(); }
+
+    // Smallest queued remaining-instruction count, or SIZE_MAX when empty
+    size_t shortestRemaining() const;
+
+    Stats stats() const;
+
+private:
+    struct Entry {
+        size_t remaining;
+        uint64_t sequence;
+        uint64_t enqueuedAt;
+        std::shared_ptr<Screen> process;
+    };
+
+    // std heap algorithms build a max-heap, so "less" means "runs later"
+    struct RunsLater {
+        bool operator()(const Entry& a, const Entry& b) const {
+            if (a.remaining != b.remaining) return a.remaining > b.remaining;
+            return a.sequence > b.sequence;
+        }
+    };
+
+    std::vector<Entry> heap;
+    uint64_t nextSequence = 0;
+    long long dispatches = 0;
+    uint64_t totalWait = 0;
+    uint64_t maxWait = 0;
+};
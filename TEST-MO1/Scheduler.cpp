@@ -1,5 +1,6 @@
 #include "Scheduler.h"
 #include "ProcessManager.h"
+#include "LogWriter.h"
 #include <iostream>
 #include <chrono>
 #include <thread>
@@ -11,12 +12,18 @@
 #include <condition_variable>
 #include <fstream>
 #include <ctime>
+#include <iomanip>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
-extern int globalProcessId;
+extern std::atomic<int> globalProcessId;
 
 extern Config config;
 extern std::atomic<int> activeCores;
-std::atomic<int> cpuTicks(0);
 
 
 class ActiveCoreGuard {
@@ -26,17 +33,115 @@ public:
     ~ActiveCoreGuard() { counter.fetch_sub(1); }
 };
 
+// One row per core plus a total. Times are ms in real mode, ticks in virtual.
+static void writeCounterTable(std::ostream& out, const std::vector<CounterValues>& rows, bool virtualClock) {
+    const double scale = virtualClock ? 1.0 : 1e-6;
+    const int precision = virtualClock ? 0 : 1;
+    auto writeRow = [&out, scale, precision](const std::string& label, const CounterValues& c) {
+        uint64_t tracked = c.busyTime + c.idleTime;
+        double busy = tracked ? 100.0 * c.busyTime / tracked : 0.0;
+        double avgWait = c.dispatches ? c.queueWait * scale / c.dispatches : 0.0;
+        out << std::setw(4) << label << std::fixed << std::setprecision(1)
+            << std::setw(8) << busy << "%" << std::setprecision(precision)
+            << std::setw(12) << c.busyTime * scale
+            << std::setw(12) << c.idleTime * scale
+            << std::setw(14) << c.instructions
+            << std::setw(12) << c.dispatches
+            << std::setw(13) << c.preemptions
+            << std::setprecision(2)
+            << std::setw(12) << avgWait
+            << std::setw(11) << c.lockWait * scale << "\n";
+    };
+
+    out << std::right << "Core   Busy%        Busy        Idle  Instructions  Dispatches  Preemptions"
+        << "  Queue Wait  Lock Wait\n";
+    CounterValues total;
+    for (size_t i = 0; i < rows.size(); ++i) {
+        writeRow(std::to_string(i), rows[i]);
+        total += rows[i];
+    }
+    writeRow("All", total);
+    out << "(Queue Wait is the average per dispatch; other times are totals)\n";
+}
+
+// delay-per-exec busy wait. Counts in a local so cores spinning at the
+// same time never share a cache line.
+static void burnDelay(int iterations) {
+    volatile int spins = 0;
+    for (int i = 0; i < iterations; ++i) {
+        spins = spins + 1;
+    }
+}
+
+// Spin-wait hint: lets the sibling hyperthread run and saves power
+static inline void cpuRelax() {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_pause();
+#elif defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
 Scheduler::Scheduler(const Config& cfg)
     : config(cfg),
     finished(false),
     numCores(cfg.numCpu),
+    coreSlots(cfg.numCpu),
     quantumCycles(cfg.quantum),
     generatingDummies(false),
-    dummyCounter(0)
+    srtfPreemptions(0),
+    lastAdapt(0),
+    burstsEnded(0),
+    queuedCount(0),
+    parkedCores(0),
+    idleSpin(std::chrono::microseconds(cfg.idleSpinUs)),
+    spinningCores(0),
+    wakeCursor(0),
+    timerEpoch(std::chrono::steady_clock::now()),
+    virtualTicks(0),
+    skippedTicks(0),
+    dummyCounter(0),
+    dummyLimit(cfg.maxProcesses),
+    arrivalElapsed(0),
+    arrivalSince(UINT64_MAX),
+    arrivalBatches(0)
 {
+    virtualClock = (config.clockMode == "virtual");
+    proceduralPrograms = (config.programMode == "procedural");
+    if (config.idleStrategy == "spin") idleStrategy = IdleStrategy::SPIN;
+    else if (config.idleStrategy == "spin-park") idleStrategy = IdleStrategy::SPIN_PARK;
+    Random::seed(config.seed);
+
+    // Sized once so cpu-set never moves a queue another thread is using
+    runQueues.resize(MAX_CORES);
+    for (int i = 0; i < numCores; ++i) {
+        runQueues[i] = std::make_unique<CoreQueue>();
+    }
+
     std::string lowerType = config.schedulerType;
     std::transform(lowerType.begin(), lowerType.end(), lowerType.begin(), ::tolower);
-    schedulerType = (lowerType == "rr") ? InternalSchedulerType::RR : InternalSchedulerType::FCFS;
+    schedulerType = (lowerType == "rr") ? InternalSchedulerType::RR
+        : (lowerType == "mlfq") ? InternalSchedulerType::MLFQ
+        : (lowerType == "sjf") ? InternalSchedulerType::SJF
+        : (lowerType == "srtf") ? InternalSchedulerType::SRTF
+        : InternalSchedulerType::FCFS;
+
+    if (schedulerType == InternalSchedulerType::MLFQ) {
+        uint64_t boostPeriod = static_cast<uint64_t>(config.mlfqBoostPeriod) * (virtualClock ? 1 : 1000000);
+        feedback = new FeedbackQueue(config.feedbackQuanta(), boostPeriod);
+        sharedQueue.reset(feedback);
+    }
+    else if (schedulerType == InternalSchedulerType::SJF || schedulerType == InternalSchedulerType::SRTF) {
+        shortestJob = new RemainingWorkQueue();
+        sharedQueue.reset(shortestJob);
+    }
+
+    if (schedulerType == InternalSchedulerType::RR && config.quantumMode == "adaptive") {
+        tuner.reset(new QuantumTuner(quantumCycles, config.quantumMin, config.quantumMax));
+        adaptInterval = static_cast<uint64_t>(config.quantumAdaptInterval) * (virtualClock ? 1 : 1000000);
+    }
 }
 
 Scheduler::~Scheduler() {
@@ -49,10 +154,21 @@ Scheduler::~Scheduler() {
 
 void Scheduler::start() {
     /*std::cout << "[Scheduler] Starting worker threads on " << numCores << " cores.\n";*/
+    if (started) return;
+    started = true;
+    startTime = std::chrono::steady_clock::now();
+
+    if (virtualClock) {
+        simCores.assign(numCores.load(), SimCore());
+        simThread = std::thread(&Scheduler::simulationLoop, this);
+        return;
+    }
+
     try {
         for (int i = 0; i < numCores; ++i) {
             cores.emplace_back(&Scheduler::worker, this, i);
         }
+        timerThread = std::thread(&Scheduler::timerLoop, this);
     }
     catch (const std::exception& e) {
         /*std::cerr << "[Scheduler] Failed to start worker threads: " << e.what() << '\n';*/
@@ -62,6 +178,49 @@ void Scheduler::start() {
     }
 }
 
+void Scheduler::setCoreCount(int count) {
+    if (count < 1 || count > MAX_CORES) {
+        throw std::runtime_error("Core count must be between 1 and " + std::to_string(MAX_CORES) + ".");
+    }
+
+    std::lock_guard<std::mutex> resizeLock(resizeMutex);
+    int current = numCores.load();
+    if (count == current) return;
+
+    // Queues of cores that ran before are reopened with their counters
+    for (int i = current; i < count; ++i) {
+        if (!runQueues[i]) runQueues[i] = std::make_unique<CoreQueue>();
+        std::lock_guard<std::mutex> lock(runQueues[i]->mtx);
+        runQueues[i]->closed = false;
+    }
+    if (count > coreSlots.load()) coreSlots.store(count);
+    numCores.store(count);
+
+    if (virtualClock) {
+        std::lock_guard<std::mutex> lock(idleMutex);
+        cv.notify_all();
+        return;
+    }
+    if (!started) return;
+
+    if (count > current) {
+        for (int i = current; i < count; ++i) {
+            cores.emplace_back(&Scheduler::worker, this, i);
+        }
+        return;
+    }
+
+    // Parked cores recheck coreRemoved() once woken
+    for (int i = count; i < current; ++i) {
+        std::lock_guard<std::mutex> lock(runQueues[i]->parkMutex);
+        runQueues[i]->parkCv.notify_all();
+    }
+    for (int i = count; i < current; ++i) {
+        if (cores[i].joinable()) cores[i].join();
+    }
+    cores.erase(cores.begin() + count, cores.end());
+}
+
 void Scheduler::joinAll() {
     for (auto& thread : cores) {
         if (thread.joinable()) {
@@ -73,100 +232,717 @@ void Scheduler::joinAll() {
         /*std::cout << "[Scheduler] Joining dummy generation thread.\n";*/
         dummyThread.join();
     }
+    if (timerThread.joinable()) {
+        timerThread.join();
+    }
+    if (simThread.joinable()) {
+        simThread.join();
+    }
 }
 
 void Scheduler::addProcess(const std::shared_ptr<Screen>& process) {
+    if (usesSharedQueue() && !virtualClock) {
+        pushShared(process, ReadyQueue::Reason::ARRIVED);
+        return;
+    }
+
+    process->markReady(clockNow());
+    {
+        std::lock_guard<std::mutex> lock(injectMutex);
+        injectQueue.push_back(process);
+    }
+    // Virtual mode traces the move from here into the simulated queues
+    if (!virtualClock) trace(TraceEvent::ENQUEUE, process, -1);
+    signalWork();
+}
+
+void Scheduler::addProcesses(const std::vector<std::shared_ptr<Screen>>& batch) {
+    if (batch.empty()) return;
+
+    uint64_t now = clockNow();
+    for (const auto& process : batch) {
+        process->markReady(now);
+        if (!virtualClock) trace(TraceEvent::ENQUEUE, process, -1);
+    }
+    if (usesSharedQueue() && !virtualClock) {
+        std::lock_guard<std::mutex> lock(sharedMutex);
+        for (const auto& process : batch) sharedQueue->push(process, ReadyQueue::Reason::ARRIVED, now);
+    }
+    else {
+        std::lock_guard<std::mutex> lock(injectMutex);
+        injectQueue.insert(injectQueue.end(), batch.begin(), batch.end());
+    }
+
+    queuedCount.fetch_add(static_cast<int>(batch.size()));
+    if (virtualClock) {
+        if (parkedCores.load() > 0) {
+            std::lock_guard<std::mutex> lock(idleMutex);
+            cv.notify_one();
+        }
+        return;
+    }
+    wakeIdleCores(static_cast<int>(std::min<size_t>(batch.size(), static_cast<size_t>(numCores.load()))));
+}
+
+void Scheduler::pushLocal(int coreId, const std::shared_ptr<Screen>& process) {
+    CoreQueue& rq = *runQueues[coreId];
+    process->markReady(clockNow());
+    bool queued = false;
+    {
+        std::lock_guard<std::mutex> lock(rq.mtx);
+        if (!rq.closed) {
+            rq.queue.push_back(process);
+            queued = true;
+        }
+    }
+    // The core was removed by cpu-set
+    if (!queued) {
+        addProcess(process);
+        return;
+    }
+    trace(TraceEvent::ENQUEUE, process, coreId);
+    signalWork(coreId);
+}
+
+void Scheduler::pushShared(const std::shared_ptr<Screen>& process, ReadyQueue::Reason reason) {
+    uint64_t now = clockNow();
+    process->markReady(now);
+    {
+        std::lock_guard<std::mutex> lock(sharedMutex);
+        sharedQueue->push(process, reason, now);
+    }
+    trace(TraceEvent::ENQUEUE, process, -1, static_cast<int64_t>(reason));
+    signalWork();
+}
+
+std::shared_ptr<Screen> Scheduler::popShared(int coreId, int& quantum) {
+    std::shared_ptr<Screen> process;
+    {
+        std::unique_lock<std::mutex> lock = lockCounted(sharedMutex, coreId);
+        process = sharedQueue->pop(clockNow(), quantum);
+    }
+    if (process) {
+        runQueues[coreId]->globalHits.fetch_add(1, std::memory_order_relaxed);
+        queuedCount.fetch_sub(1);
+    }
+    return process;
+}
+
+void Scheduler::signalWork(int preferredCore) {
+    queuedCount.fetch_add(1);
+    if (virtualClock) {
+        if (parkedCores.load() > 0) {
+            std::lock_guard<std::mutex> lock(idleMutex);
+            cv.notify_one();
+        }
+        return;
+    }
+    wakeIdleCores(1, preferredCore);
+}
+
+// queuedCount is raised before spinningCores and parkedCores are read, and
+// an idle core announces itself before it rereads queuedCount, so either
+// the producer sees the idle core or the core sees the work
+void Scheduler::wakeIdleCores(int count, int preferredCore) {
+    if (parkedCores.load() == 0) return;
+
+    // A spinning core takes the work without a wakeup
+    count -= spinningCores.load();
+    for (int i = 0; i < count; ++i) {
+        if (!wakeParkedCore(preferredCore)) return;
+        preferredCore = -1;
+    }
+}
+
+bool Scheduler::wakeParkedCore(int preferredCore) {
+    int active = numCores.load();
+    int start = preferredCore >= 0 ? preferredCore
+        : static_cast<int>(wakeCursor.fetch_add(1, std::memory_order_relaxed) % active);
+
+    for (int offset = 0; offset < active; ++offset) {
+        CoreQueue& rq = *runQueues[(start + offset) % active];
+        int expected = CORE_PARKED;
+        if (!rq.idleState.compare_exchange_strong(expected, CORE_WOKEN)) continue;
+
+        rq.wakeups.fetch_add(1, std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(rq.parkMutex);
+        rq.parkCv.notify_one();
+        return true;
+    }
+    return false;
+}
+
+void Scheduler::idleWait(int coreId) {
+    CoreQueue& rq = *runQueues[coreId];
+    auto hasWork = [this, coreId] { return finished.load() || queuedCount.load() > 0 || coreRemoved(coreId); };
+
+    if (idleStrategy != IdleStrategy::BLOCK) {
+        spinningCores.fetch_add(1);
+        auto deadline = std::chrono::steady_clock::now() + idleSpin;
+        bool found = false;
+        for (unsigned spins = 1; !(found = hasWork()); ++spins) {
+            cpuRelax();
+            if (spins % 64 != 0 || std::chrono::steady_clock::now() < deadline) continue;
+            if (idleStrategy == IdleStrategy::SPIN_PARK) break;
+            std::this_thread::yield();
+            deadline = std::chrono::steady_clock::now() + idleSpin;
+        }
+        bool lastSpinner = spinningCores.fetch_sub(1) == 1;
+
+        if (found) {
+            rq.spinHits.fetch_add(1, std::memory_order_relaxed);
+            // Producers skipped the wakeup because this core was spinning;
+            // pass any work beyond one process on to a parked core
+            if (lastSpinner && queuedCount.load() > 1) wakeParkedCore(-1);
+            return;
+        }
+    }
+
+    rq.parks.fetch_add(1, std::memory_order_relaxed);
+    rq.idleState.store(CORE_PARKED);
+    parkedCores.fetch_add(1);
+    {
+        std::unique_lock<std::mutex> lock(rq.parkMutex);
+        rq.parkCv.wait(lock, [&rq, &hasWork] { return rq.idleState.load() != CORE_PARKED || hasWork(); });
+    }
+    parkedCores.fetch_sub(1);
+    rq.idleState.store(CORE_RUNNING);
+}
+
+std::unique_lock<std::mutex> Scheduler::lockCounted(std::mutex& mtx, int coreId) {
+    std::unique_lock<std::mutex> lock(mtx, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        uint64_t start = clockNow();
+        lock.lock();
+        runQueues[coreId]->counters.lockWait.fetch_add(clockNow() - start, std::memory_order_relaxed);
+    }
+    return lock;
+}
+
+std::shared_ptr<Screen> Scheduler::popLocal(int coreId) {
+    CoreQueue& rq = *runQueues[coreId];
+    std::unique_lock<std::mutex> lock = lockCounted(rq.mtx, coreId);
+    if (rq.queue.empty()) return nullptr;
+
+    std::shared_ptr<Screen> process = rq.queue.front();
+    rq.queue.pop_front();
+    rq.localHits.fetch_add(1, std::memory_order_relaxed);
+    return process;
+}
+
+std::shared_ptr<Screen> Scheduler::popGlobal(int coreId) {
+    std::unique_lock<std::mutex> lock = lockCounted(injectMutex, coreId);
+    if (injectQueue.empty()) return nullptr;
+
+    std::shared_ptr<Screen> process = injectQueue.front();
+    injectQueue.pop_front();
+    runQueues[coreId]->globalHits.fetch_add(1, std::memory_order_relaxed);
+    return process;
+}
+
+std::shared_ptr<Screen> Scheduler::steal(int coreId) {
+    int active = numCores.load();
+    for (int offset = 1; offset < active; ++offset) {
+        int victimId = (coreId + offset) % active;
+        CoreQueue& victim = *runQueues[victimId];
+
+        std::unique_lock<std::mutex> lock(victim.mtx, std::try_to_lock);
+        if (!lock.owns_lock() || victim.queue.empty()) continue;
+
+        std::shared_ptr<Screen> process = victim.queue.back();
+        victim.queue.pop_back();
+        victim.stolenFrom.fetch_add(1, std::memory_order_relaxed);
+        runQueues[coreId]->steals.fetch_add(1, std::memory_order_relaxed);
+        trace(TraceEvent::STEAL, process, coreId, victimId);
+        return process;
+    }
+    return nullptr;
+}
+
+// Closes the local queue of a core removed by cpu-set and moves what it
+// held to the global queue; the processes stay counted in queuedCount
+void Scheduler::retireCore(int coreId) {
+    CoreQueue& rq = *runQueues[coreId];
+    std::deque<std::shared_ptr<Screen>> orphaned;
     {
-        std::lock_guard<std::mutex> lock(queueMutex);
-        screenQueue.push(process);
-        
+        std::lock_guard<std::mutex> lock(rq.mtx);
+        rq.closed = true;
+        orphaned.swap(rq.queue);
+    }
+
+    if (!orphaned.empty()) {
+        std::lock_guard<std::mutex> lock(injectMutex);
+        injectQueue.insert(injectQueue.end(), orphaned.begin(), orphaned.end());
+    }
+    for (const auto& process : orphaned) trace(TraceEvent::ENQUEUE, process, -1);
+
+    // This core may have taken a wakeup meant for a survivor
+    wakeIdleCores(std::max<int>(1, static_cast<int>(orphaned.size())));
+}
+
+// Local queue first, then newly admitted work, then steal from other cores
+std::shared_ptr<Screen> Scheduler::nextProcess(int coreId) {
+    std::shared_ptr<Screen> process = popLocal(coreId);
+    if (!process) process = popGlobal(coreId);
+    if (!process) process = steal(coreId);
+
+    if (process) queuedCount.fetch_sub(1);
+    return process;
+}
+
+void Scheduler::printStats(std::ostream& out) const {
+    long long totalLocal = 0, totalGlobal = 0, totalSteals = 0, totalInstructions = 0, totalMigrations = 0;
+
+    out << "Run Queues:\n";
+    out << std::right << "Core  Local Hits  Global Pulls  Steals  Stolen From  Migrations  Host CPU\n";
+    for (int i = 0; i < coreSlots.load(); ++i) {
+        const CoreQueue& rq = *runQueues[i];
+        long long local = rq.localHits.load();
+        long long global = rq.globalHits.load();
+        long long steals = rq.steals.load();
+
+        out << std::setw(4) << i
+            << std::setw(12) << local
+            << std::setw(14) << global
+            << std::setw(8) << steals
+            << std::setw(13) << rq.stolenFrom.load()
+            << std::setw(12) << rq.migrationsIn.load()
+            << std::setw(10) << (rq.hostCpu.load() >= 0 ? std::to_string(rq.hostCpu.load()) : "-")
+            << (i >= numCores.load() ? "  (removed)" : "") << "\n";
+
+        totalLocal += local;
+        totalMigrations += rq.migrationsIn.load();
+        totalGlobal += global;
+        totalSteals += steals;
+        totalInstructions += rq.counters.instructions.load(std::memory_order_relaxed);
+    }
+    out << std::left << std::setw(4) << "All" << std::right
+        << std::setw(12) << totalLocal
+        << std::setw(14) << totalGlobal
+        << std::setw(8) << totalSteals
+        << std::setw(13) << ""
+        << std::setw(12) << totalMigrations << "\n";
+    out << "Affinity: " << config.cpuAffinity << ", soft affinity " << (config.softAffinity ? "on" : "off") << "\n";
+
+    double elapsed = 0.0;
+    if (!cores.empty() || simThread.joinable()) {
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    }
+    double rate = elapsed > 0.0 ? totalInstructions / elapsed : 0.0;
+
+    out << "\nInterpreter:\n"
+        << "Instructions Executed: " << totalInstructions << "\n"
+        << "Instructions/sec:      " << std::fixed << std::setprecision(0) << rate << "\n";
+
+    if (virtualClock) {
+        out << "Virtual Clock:         " << virtualTicks.load() << " ticks ("
+            << skippedTicks.load() << " skipped while idle)\n";
+    }
+    else {
+        IdleStats idle = idleStats();
+        out << "\nIdle Cores (" << idle.strategy;
+        if (idleStrategy != IdleStrategy::BLOCK) out << ", spin " << config.idleSpinUs << " us";
+        out << "):\n"
+            << "Parks:                 " << idle.parks << "\n"
+            << "Targeted Wakeups:      " << idle.wakeups << "\n"
+            << "Spin Hits:             " << idle.spinHits << "\n"
+            << "Enqueue to Dispatch:   p50 " << LatencyHistogram::format(idle.dispatchLatency.percentile(0.5), false)
+            << ", p99 " << LatencyHistogram::format(idle.dispatchLatency.percentile(0.99), false)
+            << " (" << idle.dispatchLatency.count() << " dispatches)\n"
+            << "  by an idle core:     p50 " << LatencyHistogram::format(idle.wakeLatency.percentile(0.5), false)
+            << ", p99 " << LatencyHistogram::format(idle.wakeLatency.percentile(0.99), false)
+            << " (" << idle.wakeLatency.count() << " dispatches)\n";
+    }
+
+    ArrivalStats arrivals = arrivalStats();
+    const char* rateUnit = virtualClock ? "/tick" : "/sec";
+    out << "\nArrivals:\n"
+        << "Mode:                  " << arrivals.mode << "\n"
+        << std::setprecision(virtualClock ? 4 : 2)
+        << "Requested Rate:        " << arrivals.requestedRate << rateUnit << "\n"
+        << "Achieved Rate:         " << arrivals.achievedRate << rateUnit << "\n"
+        << "Processes Created:     " << arrivals.created << " in " << arrivals.batches << " batches\n"
+        << "Limit:                 " << (dummyLimit > 0 ? std::to_string(dummyLimit) : "none") << "\n";
+
+    FeedbackStats mlfq = feedbackStats();
+    if (!mlfq.levels.empty()) {
+        // Waits are converted to ms in real mode
+        const double waitScale = virtualClock ? 1.0 : 1e-6;
+        out << "\nMLFQ (" << (virtualClock ? "waits in ticks" : "waits in ms") << "):\n"
+            << "Level  Quantum  Queued  Dispatches  Avg Wait  Max Wait\n";
+        for (size_t i = 0; i < mlfq.levels.size(); ++i) {
+            const FeedbackQueue::LevelStats& level = mlfq.levels[i];
+            double avgWait = level.dispatches ? level.totalWait * waitScale / level.dispatches : 0.0;
+            out << std::setw(5) << i
+                << std::setw(9) << level.quantum
+                << std::setw(8) << level.queued
+                << std::setw(12) << level.dispatches
+                << std::setprecision(2)
+                << std::setw(10) << avgWait
+                << std::setw(10) << level.maxWait * waitScale << "\n";
+        }
+        out << "Demotions: " << mlfq.demotions << "   Promotions: " << mlfq.promotions
+            << "   Aging Boosts: " << mlfq.boosts << "\n";
+    }
+
+    if (tuner) {
+        std::vector<QuantumTuner::Decision> history = tuner->history();
+        out << "\nAdaptive Quantum:\n"
+            << "Current:               " << tuner->current() << " (bounds " << config.quantumMin
+            << "-" << config.quantumMax << ")\n"
+            << "Recent Decisions:      " << history.size() << " (changes logged to csopesy-quantum.log)\n";
+        size_t shown = std::min<size_t>(history.size(), 5);
+        for (size_t i = history.size() - shown; i < history.size(); ++i) {
+            const QuantumTuner::Decision& d = history[i];
+            out << "  " << (virtualClock ? d.time : d.time / 1000000) << (virtualClock ? " ticks" : " ms")
+                << ": quantum " << d.quantum << std::setprecision(1)
+                << " (ready/core " << d.readyPerCore << ", avg burst " << d.avgBurst << ")\n";
+        }
+    }
+
+    ShortestJobStats sjf = shortestJobStats();
+    if (sjf.enabled) {
+        const double waitScale = virtualClock ? 1.0 : 1e-6;
+        const RemainingWorkQueue::Stats& queue = sjf.queue;
+        double avgWait = queue.dispatches ? queue.totalWait * waitScale / queue.dispatches : 0.0;
+        out << "\nShortest Job Queue (" << (virtualClock ? "waits in ticks" : "waits in ms") << "):\n"
+            << "Queued:                " << queue.queued << "\n"
+            << "Dispatches:            " << queue.dispatches << "\n"
+            << std::setprecision(2)
+            << "Avg Wait:              " << avgWait << "\n"
+            << "Max Wait:              " << queue.maxWait * waitScale << "\n";
+        if (schedulerType == InternalSchedulerType::SRTF) {
+            out << "Preemptions:           " << sjf.preemptions << "\n";
+        }
     }
-    cv.notify_one();
 }
 
 void Scheduler::finish() {
     /*std::cout << "[Scheduler] Signaling finish to all threads.\n";*/
     finished.store(true);
-    cv.notify_all();
+    {
+        std::lock_guard<std::mutex> lock(idleMutex);
+        cv.notify_all();
+    }
+    for (int i = 0; i < coreSlots.load(); ++i) {
+        std::lock_guard<std::mutex> lock(runQueues[i]->parkMutex);
+        runQueues[i]->parkCv.notify_all();
+    }
+    std::lock_guard<std::mutex> lock(timerMutex);
+    timerCv.notify_all();
 }
 
-void Scheduler::worker(int coreId) {
-    /*std::cout << "[Scheduler] Worker thread started on core " << coreId << ".\n";*/
+void Scheduler::parkSleeping(const std::shared_ptr<Screen>& screen, int seconds) {
+    burstsEnded.fetch_add(1, std::memory_order_relaxed);
+    trace(TraceEvent::SLEEP, screen, screen->getCoreAssigned(), seconds);
+    screen->markDescheduled(clockNow(), false);
+    screen->setStatus(ProcessStatus::WAITING);
+    uint64_t expiry = timerNow() + static_cast<uint64_t>(seconds) * 1000;
+    bool earlier = false;
+    {
+        std::lock_guard<std::mutex> lock(timerMutex);
+        sleepers.schedule(expiry, screen);
+        if (expiry < timerDeadline) {
+            timerDeadline = expiry;
+            earlier = true;
+        }
+    }
+    // Only a new earliest deadline needs the timer thread to re-arm
+    if (earlier) timerCv.notify_one();
+}
 
-    while (true) {
-        std::shared_ptr<Screen> screen;
-        {
-            std::unique_lock<std::mutex> lock(queueMutex);
-            cv.wait(lock, [this] { return finished.load() || !screenQueue.empty(); });
+void Scheduler::timerLoop() {
+    std::vector<std::shared_ptr<Screen>> woken;
 
-            if (finished.load() && screenQueue.empty()) {
-               /* std::cout << "[Scheduler] Worker thread on core " << coreId << " exiting.\n";*/
-                return;
+    while (!finished.load()) {
+        {
+            std::unique_lock<std::mutex> lock(timerMutex);
+            if (sleepers.empty()) {
+                timerDeadline = UINT64_MAX;
+                timerCv.wait(lock, [this] { return finished.load() || !sleepers.empty(); });
+                continue;
             }
 
-            if (!screenQueue.empty()) {
-                screen = screenQueue.front();
-                screenQueue.pop();
-                screen->setCoreAssigned(coreId);
-                screen->setScheduled(true);
+            // Sleep until the earliest deadline, or until parkSleeping
+            // files an earlier one
+            uint64_t next = sleepers.nextExpiry();
+            timerDeadline = next;
+            timerCv.wait_until(lock, timerEpoch + std::chrono::milliseconds(next),
+                [this, next] { return finished.load() || timerDeadline != next; });
+            sleepers.advance(timerNow(), woken);
+        }
 
-            }
+        for (const auto& screen : woken) {
+            screen->setStatus(ProcessStatus::READY);
+            int lastCore = screen->getCoreAssigned();
+            trace(TraceEvent::WAKE, screen, config.softAffinity && !usesSharedQueue() ? lastCore : -1);
+            if (usesSharedQueue()) pushShared(screen, ReadyQueue::Reason::WOKE);
+            else if (config.softAffinity && lastCore >= 0 && lastCore < numCores.load()) pushLocal(lastCore, screen);
+            else addProcess(screen);
         }
+        woken.clear();
+    }
+}
 
-        if (screen) {
-            ActiveCoreGuard guard(activeCores);
-            screen->setStatus(ProcessStatus::RUNNING);
+uint64_t Scheduler::clockNow() const {
+    if (virtualClock) return virtualTicks.load(std::memory_order_relaxed);
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - timerEpoch).count();
+}
 
-            if (schedulerType == InternalSchedulerType::FCFS) {
-                executeProcessFCFS(screen, coreId);
-            }
-            else {
-                executeProcessRR(screen, coreId);
-            }
+void Scheduler::completeProcess(const std::shared_ptr<Screen>& screen) {
+    burstsEnded.fetch_add(1, std::memory_order_relaxed);
+    trace(TraceEvent::FINISH, screen, screen->getCoreAssigned(), screen->hasError() ? 1 : 0);
+    screen->setStatus(ProcessStatus::FINISHED);
+    screen->markFinished(clockNow());
+    screen->releaseMemory();
+}
+
+Scheduler::FeedbackStats Scheduler::feedbackStats() const {
+    FeedbackStats stats;
+    if (!feedback) return stats;
+
+    std::lock_guard<std::mutex> lock(sharedMutex);
+    stats.levels = feedback->stats();
+    stats.boosts = feedback->boosts();
+    stats.demotions = feedback->demotions();
+    stats.promotions = feedback->promotions();
+    return stats;
+}
+
+Scheduler::ShortestJobStats Scheduler::shortestJobStats() const {
+    ShortestJobStats stats;
+    if (!shortestJob) return stats;
+
+    stats.enabled = true;
+    stats.preemptions = srtfPreemptions.load();
+    std::lock_guard<std::mutex> lock(sharedMutex);
+    stats.queue = shortestJob->stats();
+    return stats;
+}
+
+Scheduler::IdleStats Scheduler::idleStats() const {
+    IdleStats stats;
+    stats.strategy = config.idleStrategy;
+    for (int i = 0; i < coreSlots.load(); ++i) {
+        const CoreQueue& rq = *runQueues[i];
+        stats.parks += rq.parks.load();
+        stats.wakeups += rq.wakeups.load();
+        stats.spinHits += rq.spinHits.load();
+        rq.dispatchLatency.addTo(stats.dispatchLatency);
+        rq.wakeLatency.addTo(stats.wakeLatency);
+    }
+    return stats;
+}
+
+bool Scheduler::shorterJobWaiting(const std::shared_ptr<Screen>& screen) {
+    size_t total = screen->getTotalInstructions();
+    size_t done = screen->getCurrentInstruction();
+    size_t remaining = total > done ? total - done : 0;
+
+    std::lock_guard<std::mutex> lock(sharedMutex);
+    return shortestJob->shortestRemaining() < remaining;
+}
+
+std::vector<Scheduler::CoreSnapshot> Scheduler::snapshotCores() const {
+    std::vector<CoreSnapshot> snapshot;
+    for (int i = 0; i < coreSlots.load(); ++i) {
+        const CoreQueue& rq = *runQueues[i];
+        CoreSnapshot core;
+        core.instructions = rq.counters.instructions.load();
+        core.dispatches = rq.counters.dispatches.load();
+        core.busyTime = rq.counters.busyTime.load();
+        core.migrations = rq.migrationsIn.load();
+        core.hostCpu = rq.hostCpu.load();
+        snapshot.push_back(core);
+    }
+    return snapshot;
+}
+
+std::vector<CounterValues> Scheduler::coreCounters() const {
+    std::vector<CounterValues> values;
+    int slots = coreSlots.load();
+    values.reserve(static_cast<size_t>(slots));
+    for (int i = 0; i < slots; ++i) values.push_back(runQueues[i]->counters.load());
+    return values;
+}
+
+void Scheduler::printCounters(std::ostream& out) const {
+    out << "Core Counters (" << (virtualClock ? "ticks" : "ms") << ", since start):\n";
+    writeCounterTable(out, coreCounters(), virtualClock);
+}
+
+void Scheduler::printVmstat(std::ostream& out) {
+    std::vector<CounterValues> now = coreCounters();
+    uint64_t time = clockNow();
+
+    std::lock_guard<std::mutex> lock(vmstatMutex);
+    std::vector<CounterValues> delta = now;
+    if (vmstatLast.size() == now.size()) {
+        for (size_t i = 0; i < now.size(); ++i) delta[i] = now[i] - vmstatLast[i];
+    }
+    uint64_t interval = time - vmstatLastTime;
+
+    out << "vmstat (" << (virtualClock ? "ticks" : "ms") << ", last "
+        << std::fixed << std::setprecision(virtualClock ? 0 : 2)
+        << (virtualClock ? interval : interval * 1e-9) << (virtualClock ? " ticks" : " s") << "):\n";
+    writeCounterTable(out, delta, virtualClock);
+
+    vmstatLast = now;
+    vmstatLastTime = time;
+}
+
+void Scheduler::setDummyLimit(int limit) {
+    dummyLimit = limit;
+}
+
+int Scheduler::getDummyCount() const {
+    return dummyCounter.load();
+}
+
+void Scheduler::resumeClock(uint64_t clock, int dummiesCreated) {
+    if (virtualClock) virtualTicks.store(clock);
+    else timerEpoch -= std::chrono::nanoseconds(clock);
+
+    std::vector<std::shared_ptr<Screen>> none;
+    sleepers.advance(virtualClock ? clock : timerNow(), none);
+    lastAdapt.store(clock);
+    vmstatLastTime = clock;
+    dummyCounter.store(dummiesCreated);
+    restoredDummies = dummiesCreated;
+}
+
+bool Scheduler::belowDummyLimit() const {
+    return dummyLimit <= 0 || dummyCounter.load() < dummyLimit;
+}
+
+// Without arrival-rate, one process every batch-process-freq ms (or ticks)
+double Scheduler::requestedArrivalRate() const {
+    if (config.arrivalRate > 0.0) return config.arrivalRate;
+    return virtualClock ? 1.0 / config.batchFreq : 1000.0 / config.batchFreq;
+}
+
+ArrivalProcess Scheduler::makeArrivalProcess(unsigned int seed) const {
+    double rate = requestedArrivalRate();
+    double meanGap = virtualClock ? 1.0 / rate : 1000.0 / rate;
+    return ArrivalProcess(ArrivalProcess::parseMode(config.arrivalMode), meanGap, config.burstSize, seed);
+}
+
+void Scheduler::beginArrivalPeriod() {
+    arrivalSince.store(clockNow());
+}
+
+void Scheduler::endArrivalPeriod() {
+    uint64_t since = arrivalSince.exchange(UINT64_MAX);
+    uint64_t now = clockNow();
+    if (since != UINT64_MAX && now > since) arrivalElapsed.fetch_add(now - since);
+}
+
+Scheduler::ArrivalStats Scheduler::arrivalStats() const {
+    ArrivalStats stats;
+    stats.mode = ArrivalProcess::modeName(ArrivalProcess::parseMode(config.arrivalMode));
+    stats.requestedRate = requestedArrivalRate();
+    stats.created = dummyCounter.load() - restoredDummies;
+    stats.batches = arrivalBatches.load();
+
+    // Elapsed generating time is in ns for real mode, ticks for virtual mode
+    uint64_t since = arrivalSince.load();
+    uint64_t now = clockNow();
+    double elapsed = static_cast<double>(arrivalElapsed.load() + (since != UINT64_MAX && now > since ? now - since : 0));
+    if (!virtualClock) elapsed /= 1e9;
+    stats.achievedRate = elapsed > 0.0 ? stats.created / elapsed : 0.0;
+    return stats;
+}
+
+uint64_t Scheduler::timerNow() const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - timerEpoch).count();
+}
+
+void Scheduler::worker(int coreId) {
+    /*std::cout << "[Scheduler] Worker thread started on core " << coreId << ".\n";*/
+    LogWriter::bindCore(coreId);
+    Tracer::bindCore(coreId);
+    pinThread(coreId);
+
+    bool wasIdle = false;
+    while (!finished.load() && !coreRemoved(coreId)) {
+        uint64_t lookupStart = clockNow();
+        int quantum = tuner ? tuner->current() : quantumCycles;
+        std::shared_ptr<Screen> screen = usesSharedQueue()
+            ? popShared(coreId, quantum) : nextProcess(coreId);
+
+        CoreQueue& rq = *runQueues[coreId];
+        if (!screen) {
+            idleWait(coreId);
+            rq.counters.idleTime.fetch_add(clockNow() - lookupStart, std::memory_order_relaxed);
+            wasIdle = true;
+            continue;
         }
+
+        uint64_t dispatchTime = clockNow();
+        uint64_t readyWait = 0;
+        rq.counters.dispatches.fetch_add(1, std::memory_order_relaxed);
+        if (screen->beginDispatch(coreId, dispatchTime, readyWait)) rq.migrationsIn.fetch_add(1, std::memory_order_relaxed);
+        rq.counters.queueWait.fetch_add(readyWait, std::memory_order_relaxed);
+        rq.dispatchLatency.add(readyWait);
+        if (wasIdle) rq.wakeLatency.add(readyWait);
+        wasIdle = false;
+        trace(TraceEvent::DISPATCH, screen, coreId, quantum);
+        rq.dispatchOverhead.fetch_add(clockNow() - lookupStart, std::memory_order_relaxed);
+        if (tuner) maybeAdaptQuantum(dispatchTime);
+
+        ActiveCoreGuard guard(activeCores);
+
+        if (schedulerType == InternalSchedulerType::FCFS || schedulerType == InternalSchedulerType::SJF) {
+            executeProcessFCFS(screen, coreId);
+        }
+        else {
+            executeProcessRR(screen, coreId, quantum);
+        }
+        rq.counters.busyTime.fetch_add(clockNow() - dispatchTime, std::memory_order_relaxed);
     }
+    if (coreRemoved(coreId)) retireCore(coreId);
+   /* std::cout << "[Scheduler] Worker thread on core " << coreId << " exiting.\n";*/
 }
 
 void Scheduler::executeProcessFCFS(const std::shared_ptr<Screen>& screen, int coreId) {
+    CoreQueue& rq = *runQueues[coreId];
     try {
-        screen->setCoreAssigned(coreId);
-        std::ofstream logFile(screen->getName() + ".txt");
-
-        while (!screen->isFinished() && !finished.load()) {
-            if (screen->getCurrentInstruction() >= screen->getTotalInstructions()) {
-                screen->setStatus(ProcessStatus::FINISHED);
-                screen->printLog("Process finished execution.");
-                break;
-            }
+        while (!finished.load()) {
+            burnDelay(config.delayPerExec);
 
-          /*  std::cout << "[Scheduler][FCFS] Core " << coreId << " executing instruction "
-                << screen->getCurrentInstruction() + 1 << " / "
-                << screen->getTotalInstructions() << " on process '"
-                << screen->getName() << "'\n";*/
+            // Without a per-instruction delay whole batches run under one
+            // lock; the batch bound keeps shutdown responsive
+            SliceResult slice = screen->runSlice(config.delayPerExec > 0 ? 1 : FCFS_BATCH);
+            rq.counters.instructions.fetch_add(slice.executed, std::memory_order_relaxed);
 
-            for (int i = 0; i < config.delayPerExec; ++i) {
-                ++cpuTicks;
+            if (slice.error) {
+                handleProcessError(screen, slice.errorMessage);
+                return;
             }
-
-            try {
-                /*auto timestamp = currentTimestamp();
-                logFile << timestamp << " Core:" << coreId
-                    << " \"Hello world from " << screen->getName() << "!\"\n";
-                logFile.flush();*/
-
-                screen->executeNextInstruction();
+            if (slice.finished) {
+                completeProcess(screen);
+                screen->printLog("FCFS: Process completed on core " + std::to_string(coreId));
+                std::cout << "[Scheduler][FCFS] Process '" << screen->getName()
+                    << "' finished on core " << coreId << ".\n";
+                return;
             }
-            catch (const std::exception& e) {
-                handleProcessError(screen, e.what());
-                break;
+            if (slice.sleepFor > 0) {
+                parkSleeping(screen, slice.sleepFor);
+                return;
             }
-        }
 
-        if (!screen->hasError()) {
-            screen->setStatus(ProcessStatus::FINISHED);
-            screen->printLog("FCFS: Process completed on core " + std::to_string(coreId));
-            std::cout << "[Scheduler][FCFS] Process '" << screen->getName()
-                << "' finished on core " << coreId << ".\n";
+            // A removed core preempts at the batch boundary
+            if (coreRemoved(coreId)) {
+                rq.counters.preemptions.fetch_add(1, std::memory_order_relaxed);
+                screen->markDescheduled(clockNow(), true);
+                trace(TraceEvent::PREEMPT, screen, coreId, slice.executed);
+                screen->setStatus(ProcessStatus::READY);
+                if (usesSharedQueue()) pushShared(screen, ReadyQueue::Reason::PREEMPTED);
+                else addProcess(screen);
+                return;
+            }
         }
     }
     catch (const std::exception& e) {
@@ -175,55 +951,57 @@ void Scheduler::executeProcessFCFS(const std::shared_ptr<Screen>& screen, int co
     }
 }
 
-void Scheduler::executeProcessRR(const std::shared_ptr<Screen>& screen, int coreId) {
+// Also runs MLFQ and SRTF slices. For MLFQ `quantum` is the level's quantum
+// and a process that uses all of it is demoted when requeued; SRTF only
+// gives up the core at a quantum boundary if a shorter job is waiting.
+void Scheduler::executeProcessRR(const std::shared_ptr<Screen>& screen, int coreId, int quantum) {
+    CoreQueue& rq = *runQueues[coreId];
     try {
-        screen->setCoreAssigned(coreId);
-        std::ofstream logFile(screen->getName() + ".txt", std::ios::app);
         int executed = 0;
 
-        while (!screen->isFinished() && executed < quantumCycles && !finished.load()) {
-            if (screen->getCurrentInstruction() >= screen->getTotalInstructions()) {
-                screen->setStatus(ProcessStatus::FINISHED);
-                break;
-            }
-
-            for (int i = 0; i < config.delayPerExec; ++i) {
-                ++cpuTicks;
-            }
-
-            try {
-                auto timestamp = currentTimestamp();
-                /*logFile << timestamp << " Core:" << coreId
-                    << " \"Executing instruction " << screen->getCurrentInstruction()
-                    << " from process " << screen->getName() << "\"\n";
-                logFile.flush();*/
+        while (executed < quantum && !finished.load()) {
+            burnDelay(config.delayPerExec);
 
-                screen->executeNextInstruction();
+            SliceResult slice = screen->runSlice(config.delayPerExec > 0 ? 1 : quantum - executed);
+            rq.counters.instructions.fetch_add(slice.executed, std::memory_order_relaxed);
+            executed += slice.executed;
 
-                if (screen->hasError()) {
-                    handleProcessError(screen, "Error encountered during instruction execution.");
-                    break;
-                }
-
-                ++executed;
+            if (slice.error) {
+                handleProcessError(screen, slice.errorMessage);
+                return;
             }
-            catch (const std::exception& e) {
-                handleProcessError(screen, e.what());
-                break;
+            if (slice.finished) {
+                completeProcess(screen);
+                return;
             }
-        }
-
-        if (!screen->hasError()) {
-            if (screen->getCurrentInstruction() >= screen->getTotalInstructions()) {
-                screen->setStatus(ProcessStatus::FINISHED);
-
+            if (slice.sleepFor > 0) {
+                parkSleeping(screen, slice.sleepFor);
+                return;
             }
-            else {
-                screen->setStatus(ProcessStatus::READY);
-                addProcess(screen);
 
+            if (executed >= quantum && schedulerType == InternalSchedulerType::SRTF
+                && !coreRemoved(coreId) && !shorterJobWaiting(screen)) {
+                executed = 0;
             }
         }
+
+        bool preempted = executed >= quantum;
+        if (preempted) rq.counters.preemptions.fetch_add(1, std::memory_order_relaxed);
+        screen->markDescheduled(clockNow(), preempted);
+        trace(TraceEvent::PREEMPT, screen, coreId, executed);
+        if (usesSharedQueue()) {
+            if (preempted && schedulerType == InternalSchedulerType::SRTF) srtfPreemptions.fetch_add(1);
+            screen->setStatus(ProcessStatus::READY);
+            pushShared(screen, ReadyQueue::Reason::PREEMPTED);
+        }
+        else if (config.softAffinity) {
+            screen->setStatus(ProcessStatus::READY);
+            pushLocal(coreId, screen);
+        }
+        else {
+            screen->setStatus(ProcessStatus::READY);
+            addProcess(screen);
+        }
     }
     catch (const std::exception& e) {
 
@@ -237,6 +1015,13 @@ void Scheduler::startDummyGeneration() {
         return;
     }
 
+    // The simulation thread generates arrivals itself on the virtual clock
+    if (virtualClock) {
+        std::lock_guard<std::mutex> lock(idleMutex);
+        cv.notify_all();
+        return;
+    }
+
     if (dummyThread.joinable()) {
         dummyThread.join();
     }
@@ -246,6 +1031,10 @@ void Scheduler::startDummyGeneration() {
 
 void Scheduler::stopDummyGeneration() {
     generatingDummies.store(false);
+    {
+        std::lock_guard<std::mutex> lock(generatorMutex);
+        generatorCv.notify_all();
+    }
     if (dummyThread.joinable()) {
         dummyThread.join();
     }
@@ -255,42 +1044,44 @@ void Scheduler::stopDummyGeneration() {
 void Scheduler::dummyProcessLoop() {
     /*std::cout << "[Scheduler] Dummy process generation started.\n";*/
 
+    // Arrivals that fall due while the generator sleeps or lags behind are
+    // created together and admitted as one batch
+    const size_t maxBatch = 1024;
+
     try {
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_int_distribution<> dist(config.minIns, config.maxIns);
+        using Clock = std::chrono::steady_clock;
+        ArrivalProcess arrivals = makeArrivalProcess(config.seed + 1);
+        std::vector<std::shared_ptr<Screen>> batch;
+        batch.reserve(maxBatch);
 
-        dummyCounter = 0;
-        auto lastGenTime = std::chrono::steady_clock::now();
+        const Clock::time_point periodStart = Clock::now();
+        beginArrivalPeriod();
+        double nextArrival = arrivals.nextGap();   // ms since periodStart
 
         while (generatingDummies.load()) {
-            auto now = std::chrono::steady_clock::now();
-            auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastGenTime).count();
-
-            if (dummyCounter >= 50) {
-                /*std::cout << "[Scheduler] Dummy process limit reached (50). Stopping generation.\n";*/
+            if (!belowDummyLimit()) {
+                /*std::cout << "[Scheduler] Dummy process limit reached. Stopping generation.\n";*/
                 break;
             }
 
-            if (elapsedMs >= config.batchFreq) {
-                std::string name = "process" + std::to_string(++dummyCounter);
-                /*std::cout << "[Scheduler] Generating dummy process: " << name << " (ID: " << globalProcessId << ")\n";*/
-
-                auto screen = std::make_shared<Screen>();
-                screen->setName(name);
-                screen->generateDummyInstructions(config);
+            Clock::duration sinceStart = Clock::now() - periodStart;
+            double nowMs = std::chrono::duration<double, std::milli>(sinceStart).count();
 
-                int instructionCount = dist(gen);
-                screen->truncateInstructions(instructionCount);
-                screen->setProcessId(globalProcessId++);
-                screen->setStatus(ProcessStatus::READY);
-				ProcessManager::registerProcess(screen);
-                addProcess(screen);
-
-                lastGenTime = now;
+            while (nextArrival <= nowMs && belowDummyLimit() && batch.size() < maxBatch) {
+                batch.push_back(createDummyProcess());
+                nextArrival += arrivals.nextGap();
+            }
+            if (!batch.empty()) {
+                addProcesses(batch);
+                arrivalBatches.fetch_add(1);
+                batch.clear();
             }
-            else {
-                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+            if (nextArrival > nowMs) {
+                Clock::time_point due = periodStart
+                    + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(nextArrival));
+                std::unique_lock<std::mutex> lock(generatorMutex);
+                generatorCv.wait_until(lock, due, [this] { return !generatingDummies.load(); });
             }
         }
     }
@@ -300,10 +1091,315 @@ void Scheduler::dummyProcessLoop() {
     catch (...) {
        /* std::cerr << "[Scheduler] Unknown exception in dummyProcessLoop.\n";*/
     }
+    endArrivalPeriod();
 
     /*std::cout << "[Scheduler] Dummy process generation ended.\n";*/
 }
 
+std::shared_ptr<Screen> Scheduler::createDummyProcess() {
+    std::string name = "process" + std::to_string(++dummyCounter);
+    /*std::cout << "[Scheduler] Generating dummy process: " << name << " (ID: " << globalProcessId << ")\n";*/
+
+    auto screen = std::make_shared<Screen>();
+    screen->setName(name);
+    screen->setProcessId(globalProcessId++);
+
+    // Everything random about the process comes from its own stream
+    Xoshiro256 rng = Random::forProcess(config.seed, screen->getProcessId());
+    int instructionCount = rng.range(config.minIns, config.maxIns);
+    if (proceduralPrograms) {
+        screen->generateProceduralInstructions(rng(), instructionCount, config.forNestingDepth);
+    }
+    else {
+        screen->generateDummyInstructions(config, instructionCount, rng);
+    }
+    screen->setStatus(ProcessStatus::READY);
+    ProcessManager::registerProcess(screen);
+    return screen;
+}
+
+void Scheduler::simulationLoop() {
+    LogWriter::bindCore(0);
+    Tracer::bindCore(0);
+    pinThread(0);
+
+    ArrivalProcess arrivals = makeArrivalProcess(config.seed + 1);
+    std::vector<std::shared_ptr<Screen>> woken;
+    uint64_t now = virtualTicks.load();
+    double nextArrival = 0.0;
+    bool wasGenerating = false;
+
+    while (!finished.load()) {
+        if (static_cast<int>(simCores.size()) != numCores.load()) resizeSimCores(now);
+
+        bool generating = generatingDummies.load() && belowDummyLimit();
+        if (generating && !wasGenerating) {
+            nextArrival = now + arrivals.nextGap();
+            beginArrivalPeriod();
+        }
+        else if (!generating && wasGenerating) {
+            endArrivalPeriod();
+        }
+        wasGenerating = generating;
+
+        if (generating) {
+            bool admitted = false;
+            while (nextArrival <= now && belowDummyLimit()) {
+                auto screen = createDummyProcess();
+                screen->markReady(now);
+                simEnqueue(screen, ReadyQueue::Reason::ARRIVED, now);
+                nextArrival += arrivals.nextGap();
+                admitted = true;
+            }
+            if (admitted) arrivalBatches.fetch_add(1);
+        }
+
+        sleepers.advance(now, woken);
+        for (const auto& screen : woken) {
+            screen->setStatus(ProcessStatus::READY);
+            screen->markReady(now);
+            trace(TraceEvent::WAKE, screen, -1);
+            simEnqueue(screen, ReadyQueue::Reason::WOKE, now);
+        }
+        woken.clear();
+
+        if (queuedCount.load() > 0) {
+            std::lock_guard<std::mutex> lock(injectMutex);
+            for (const auto& screen : injectQueue) simEnqueue(screen, ReadyQueue::Reason::ARRIVED, now);
+            queuedCount.fetch_sub(static_cast<int>(injectQueue.size()));
+            injectQueue.clear();
+        }
+
+        bool busy = false;
+        for (int coreId = 0; coreId < static_cast<int>(simCores.size()); ++coreId) {
+            simulateCore(coreId, now);
+            if (simCores[coreId].screen) busy = true;
+        }
+
+        if (tuner) maybeAdaptQuantum(now);
+        virtualTicks.store(++now);
+
+        if (busy || simHasReady() || queuedCount.load() > 0) continue;
+
+        // Every core is idle: jump straight to the next wakeup or arrival
+        uint64_t next = sleepers.nextExpiry();
+        if (generating) next = std::min(next, static_cast<uint64_t>(std::ceil(nextArrival)));
+
+        if (next == UINT64_MAX) {
+            parkedCores.fetch_add(1);
+            {
+                std::unique_lock<std::mutex> lock(idleMutex);
+                cv.wait(lock, [this, generating] {
+                    return finished.load() || queuedCount.load() > 0
+                        || (generatingDummies.load() && belowDummyLimit()) != generating
+                        || static_cast<int>(simCores.size()) != numCores.load();
+                });
+            }
+            parkedCores.fetch_sub(1);
+        }
+        else if (next > now) {
+            skippedTicks.fetch_add(next - now);
+            for (size_t i = 0; i < simCores.size(); ++i) {
+                runQueues[i]->counters.idleTime.fetch_add(next - now, std::memory_order_relaxed);
+            }
+            now = next;
+            virtualTicks.store(now);
+        }
+    }
+}
+
+// One virtual tick of an emulated core: dispatch if idle, burn a delay
+// tick, or execute one instruction and handle sleep/finish/preemption
+void Scheduler::simulateCore(int coreId, uint64_t now) {
+    SimCore& core = simCores[coreId];
+    CoreCounters& counters = runQueues[coreId]->counters;
+
+    if (!core.screen) {
+        core.quantum = tuner ? tuner->current() : quantumCycles;
+        if (usesSharedQueue()) {
+            std::lock_guard<std::mutex> lock(sharedMutex);
+            core.screen = sharedQueue->pop(now, core.quantum);
+        }
+        else {
+            core.screen = popSimReady(coreId);
+        }
+        if (!core.screen) {
+            counters.idleTime.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        core.sliceUsed = 0;
+        core.delayLeft = config.delayPerExec;
+
+        uint64_t readyWait = 0;
+        if (core.screen->beginDispatch(coreId, now, readyWait)) {
+            runQueues[coreId]->migrationsIn.fetch_add(1, std::memory_order_relaxed);
+        }
+        runQueues[coreId]->globalHits.fetch_add(1, std::memory_order_relaxed);
+        counters.dispatches.fetch_add(1, std::memory_order_relaxed);
+        counters.queueWait.fetch_add(readyWait, std::memory_order_relaxed);
+        trace(TraceEvent::DISPATCH, core.screen, coreId, core.quantum);
+    }
+
+    counters.busyTime.fetch_add(1, std::memory_order_relaxed);
+
+    if (core.delayLeft > 0) {
+        --core.delayLeft;
+        return;
+    }
+
+    std::shared_ptr<Screen> screen = core.screen;
+    core.delayLeft = config.delayPerExec;
+
+    SliceResult slice = screen->runSlice(1);
+    counters.instructions.fetch_add(slice.executed, std::memory_order_relaxed);
+
+    if (slice.error) {
+        handleProcessError(screen, slice.errorMessage);
+        core.screen.reset();
+        return;
+    }
+
+    // The instruction occupied this whole tick, so the slice ends at now + 1
+    if (slice.finished) {
+        screen->markDescheduled(now + 1, false);
+        completeProcess(screen);
+        core.screen.reset();
+    }
+    else if (slice.sleepFor > 0) {
+        screen->markDescheduled(now + 1, false);
+        trace(TraceEvent::SLEEP, screen, coreId, slice.sleepFor);
+        screen->setStatus(ProcessStatus::WAITING);
+        burstsEnded.fetch_add(1, std::memory_order_relaxed);
+        sleepers.schedule(now + slice.sleepFor, screen);
+        core.screen.reset();
+    }
+    else if (schedulerType != InternalSchedulerType::FCFS && schedulerType != InternalSchedulerType::SJF
+        && ++core.sliceUsed >= core.quantum) {
+        if (schedulerType == InternalSchedulerType::SRTF && !shorterJobWaiting(screen)) {
+            core.sliceUsed = 0;
+            return;
+        }
+        if (schedulerType == InternalSchedulerType::SRTF) srtfPreemptions.fetch_add(1);
+        counters.preemptions.fetch_add(1, std::memory_order_relaxed);
+        screen->markDescheduled(now + 1, true);
+        trace(TraceEvent::PREEMPT, screen, coreId, core.sliceUsed);
+
+        screen->setStatus(ProcessStatus::READY);
+        screen->markReady(now + 1);
+        simEnqueue(screen, ReadyQueue::Reason::PREEMPTED, now + 1);
+        core.screen.reset();
+    }
+}
+
+void Scheduler::simEnqueue(const std::shared_ptr<Screen>& screen, ReadyQueue::Reason reason, uint64_t now) {
+    trace(TraceEvent::ENQUEUE, screen, -1, static_cast<int64_t>(reason));
+    if (usesSharedQueue()) {
+        std::lock_guard<std::mutex> lock(sharedMutex);
+        sharedQueue->push(screen, reason, now);
+    }
+    else {
+        simReady.push_back(screen);
+    }
+}
+
+void Scheduler::resizeSimCores(uint64_t now) {
+    size_t count = static_cast<size_t>(numCores.load());
+    for (size_t coreId = count; coreId < simCores.size(); ++coreId) {
+        SimCore& core = simCores[coreId];
+        if (!core.screen) continue;
+
+        runQueues[coreId]->counters.preemptions.fetch_add(1, std::memory_order_relaxed);
+        core.screen->markDescheduled(now, true);
+        trace(TraceEvent::PREEMPT, core.screen, static_cast<int>(coreId), core.sliceUsed);
+        core.screen->setStatus(ProcessStatus::READY);
+        core.screen->markReady(now);
+        simEnqueue(core.screen, ReadyQueue::Reason::PREEMPTED, now);
+    }
+    simCores.resize(count);
+}
+
+// Looks only a few entries deep so dispatch stays O(1)
+std::shared_ptr<Screen> Scheduler::popSimReady(int coreId) {
+    if (simReady.empty()) return nullptr;
+
+    size_t pick = 0;
+    if (config.softAffinity) {
+        const size_t window = std::min<size_t>(simReady.size(), 4);
+        for (size_t i = 0; i < window; ++i) {
+            if (simReady[i]->getCoreAssigned() == coreId) {
+                pick = i;
+                break;
+            }
+        }
+    }
+
+    std::shared_ptr<Screen> screen = simReady[pick];
+    simReady.erase(simReady.begin() + pick);
+    return screen;
+}
+
+void Scheduler::maybeAdaptQuantum(uint64_t now) {
+    if (now - lastAdapt.load(std::memory_order_relaxed) < adaptInterval) return;
+
+    std::unique_lock<std::mutex> lock(adaptMutex, std::try_to_lock);
+    if (!lock.owns_lock() || now - lastAdapt.load() < adaptInterval) return;
+    lastAdapt.store(now);
+
+    QuantumTuner::Sample sample;
+    sample.now = now;
+    sample.cores = numCores.load();
+    sample.burstsEnded = burstsEnded.load();
+    sample.readyProcesses = std::max(queuedCount.load(), 0);
+    if (virtualClock) sample.readyProcesses += static_cast<int>(simReady.size());
+    for (int i = 0; i < coreSlots.load(); ++i) {
+        const CoreQueue& rq = *runQueues[i];
+        sample.instructions += rq.counters.instructions.load();
+        sample.dispatches += rq.counters.dispatches.load();
+        sample.busyTime += rq.counters.busyTime.load();
+        sample.dispatchOverhead += rq.dispatchOverhead.load();
+    }
+
+    int before = tuner->current();
+    QuantumTuner::Decision decision = tuner->adapt(sample);
+    if (decision.quantum == before) return;
+
+    // Real mode logs milliseconds, virtual mode ticks
+    std::ostringstream line;
+    line << std::fixed << std::setprecision(2)
+        << (virtualClock ? "tick=" : "ms=") << (virtualClock ? now : now / 1000000)
+        << " quantum=" << decision.quantum
+        << " ready_per_core=" << decision.readyPerCore
+        << " avg_burst=" << decision.avgBurst
+        << " dispatch_overhead=" << decision.overheadPerDispatch
+        << " time_per_instruction=" << decision.timePerInstruction;
+    LogWriter::write("csopesy-quantum.log", line.str());
+}
+
+int Scheduler::currentQuantum() const {
+    return tuner ? tuner->current() : quantumCycles;
+}
+
+std::vector<QuantumTuner::Decision> Scheduler::quantumHistory() const {
+    if (!tuner) return {};
+    return tuner->history();
+}
+
+void Scheduler::pinThread(int coreId) {
+    if (config.cpuAffinity != "pinned") return;
+
+    int hostCpu = HostAffinity::hostCpuFor(coreId, config.cpuAffinityMap);
+    if (HostAffinity::pinCurrentThread(hostCpu)) {
+        runQueues[coreId]->hostCpu.store(hostCpu);
+    }
+}
+
+bool Scheduler::simHasReady() const {
+    if (!usesSharedQueue()) return !simReady.empty();
+    std::lock_guard<std::mutex> lock(sharedMutex);
+    return !sharedQueue->empty();
+}
+
 std::string Scheduler::currentTimestamp() {
     time_t now = time(nullptr);
     tm ltm{};
@@ -319,7 +1415,7 @@ std::string Scheduler::currentTimestamp() {
 
 void Scheduler::handleProcessError(const std::shared_ptr<Screen>& screen, const std::string& message) {
     screen->setError(true);
-    screen->setStatus(ProcessStatus::FINISHED);
+    completeProcess(screen);
     screen->printLog("Error during instruction execution: " + message);
     std::cerr << "[Scheduler][ProcessError] Process '" << screen->getName()
         << "' encountered an error: " << message << "\n";
@@ -2,15 +2,26 @@
 
 #include <string>
 #include <vector>
-#include <queue>
+#include <deque>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
 #include <memory>
 #include <atomic>
+#include <chrono>
 
 #include "Config.h"
 #include "Screen.h"
+#include "TimerWheel.h"
+#include "ArrivalProcess.h"
+#include "FeedbackQueue.h"
+#include "RemainingWorkQueue.h"
+#include "HostAffinity.h"
+#include "QuantumTuner.h"
+#include "CoreCounters.h"
+#include "LatencyHistogram.h"
+#include "Tracer.h"
+#include "Random.h"
 
 // Scheduler class responsible for managing processes and CPU cores
 class Scheduler {
@@ -21,28 +32,228 @@ public:
     void start();
     void finish();
 
+    // Grows or shrinks the set of emulated cores while running (1 to
+    // MAX_CORES). New cores start taking work at once; removed cores end
+    // their current slice and hand their queued processes to the global
+    // queue. In real clock mode this returns after the removed cores'
+    // threads have exited; in virtual mode the simulation thread applies
+    // the change on its next tick.
+    static constexpr int MAX_CORES = 128;
+    void setCoreCount(int count);
+    int coreCount() const { return numCores.load(); }
+
     void addProcess(const std::shared_ptr<Screen>& process);
+    // Admits a whole batch with one queue lock and one wakeup
+    void addProcesses(const std::vector<std::shared_ptr<Screen>>& batch);
+
+    // Prints per-core run queue balance (local hits, global pulls, steals)
+    // and interpreter throughput since start()
+    void printStats(std::ostream& out) const;
 
     void startDummyGeneration();
     void stopDummyGeneration();
 
+    // Caps how many dummy processes the generator creates
+    // (default max-processes; 0 = no limit)
+    void setDummyLimit(int limit);
+    int getDummyCount() const;
+
+    // Continues the clock and dummy numbering of a restored checkpoint;
+    // call before start()
+    void resumeClock(uint64_t clock, int dummiesCreated);
+
+    // Requested vs. achieved arrival rate, per second (per tick in virtual mode)
+    struct ArrivalStats {
+        const char* mode = "fixed";
+        double requestedRate = 0.0;
+        double achievedRate = 0.0;
+        long long created = 0;
+        long long batches = 0;
+    };
+    ArrivalStats arrivalStats() const;
+
+    // Scheduler clock: nanoseconds since construction, or virtual ticks
+    uint64_t clockNow() const;
+    bool usesVirtualClock() const { return virtualClock; }
+
+    struct CoreSnapshot {
+        long long instructions = 0;
+        long long dispatches = 0;
+        uint64_t busyTime = 0;     // in clockNow() units
+        long long migrations = 0;
+        int hostCpu = -1;
+    };
+    std::vector<CoreSnapshot> snapshotCores() const;
+
+    // Per-core hot-path counters, one entry per core
+    std::vector<CounterValues> coreCounters() const;
+    // Counter table since start (report-util), or since the previous
+    // call (vmstat)
+    void printCounters(std::ostream& out) const;
+    void printVmstat(std::ostream& out);
+
+    // Per-level MLFQ queue lengths and waits; empty levels when not "mlfq"
+    struct FeedbackStats {
+        std::vector<FeedbackQueue::LevelStats> levels;
+        long long boosts = 0;
+        long long demotions = 0;
+        long long promotions = 0;
+    };
+    FeedbackStats feedbackStats() const;
+
+    // Remaining-work heap stats for "sjf" and "srtf"
+    struct ShortestJobStats {
+        bool enabled = false;
+        RemainingWorkQueue::Stats queue;
+        long long preemptions = 0;
+    };
+    ShortestJobStats shortestJobStats() const;
+
+    // Idle cores (real clock mode): how often they parked, were woken by a
+    // producer or found work while spinning, and enqueue-to-dispatch
+    // latency over all dispatches and over dispatches by a core that was idle
+    struct IdleStats {
+        std::string strategy;
+        long long parks = 0;
+        long long wakeups = 0;
+        long long spinHits = 0;
+        LatencyHistogram dispatchLatency;
+        LatencyHistogram wakeLatency;
+    };
+    IdleStats idleStats() const;
+
+    // Adaptive rr quantum: the quantum in use and recent decisions
+    // (empty history with quantum-mode fixed)
+    int currentQuantum() const;
+    std::vector<QuantumTuner::Decision> quantumHistory() const;
+
 private:
-    enum class InternalSchedulerType { FCFS, RR };
+    enum class InternalSchedulerType { FCFS, RR, MLFQ, SJF, SRTF };
+    enum class IdleStrategy { BLOCK, SPIN, SPIN_PARK };
+    enum { CORE_RUNNING, CORE_PARKED, CORE_WOKEN };
 
     bool scheduled = false;
+    bool started = false;   // start() runs once; later calls are no-ops
+    bool virtualClock = false;
+    bool proceduralPrograms = true;
+
+    // Per-core ready queue. The owning core pushes and pops locally,
+    // idle cores steal from the back of a victim's queue.
+    struct CoreQueue {
+        std::mutex mtx;
+        std::deque<std::shared_ptr<Screen>> queue;
+        // Set under mtx when the core is removed; later pushes go global
+        bool closed = false;
+
+        std::atomic<long long> localHits{ 0 };
+        std::atomic<long long> globalHits{ 0 };
+        std::atomic<long long> steals{ 0 };
+        std::atomic<long long> stolenFrom{ 0 };
+
+        // Written only by the owning core, on a cache line of their own
+        CoreCounters counters;
+
+        // Dispatches of a process that last ran on another core
+        std::atomic<long long> migrationsIn{ 0 };
+        // Host CPU the core's thread is pinned to, or -1
+        std::atomic<int> hostCpu{ -1 };
+
+        // Time spent finding and setting up the next process, in clockNow() units
+        std::atomic<uint64_t> dispatchOverhead{ 0 };
+
+        // A parked core sleeps on its own condition variable, so a producer
+        // wakes exactly the core it claimed (idleState PARKED -> WOKEN)
+        std::atomic<int> idleState{ CORE_RUNNING };
+        std::mutex parkMutex;
+        std::condition_variable parkCv;
+        std::atomic<long long> parks{ 0 };
+        std::atomic<long long> wakeups{ 0 };
+        std::atomic<long long> spinHits{ 0 };
+
+        // Enqueue to dispatch, written only by the owning core
+        SharedLatencyHistogram dispatchLatency;
+        SharedLatencyHistogram wakeLatency;
+    };
 
     // Worker thread function for each CPU core
     void worker(int coreId);
 
-    // Scheduling strategies
+    // cpu-set: a removed core leaves its worker loop at the next slice
+    // boundary, then closes and drains its local queue
+    bool coreRemoved(int coreId) const { return coreId >= numCores.load(std::memory_order_relaxed); }
+    void retireCore(int coreId);
+    // Virtual mode: requeues processes on removed sim cores, adds new ones
+    void resizeSimCores(uint64_t now);
+
+    // Run queue helpers
+    void pushLocal(int coreId, const std::shared_ptr<Screen>& process);
+    std::shared_ptr<Screen> popLocal(int coreId);
+    std::shared_ptr<Screen> popGlobal(int coreId);
+    std::shared_ptr<Screen> steal(int coreId);
+    std::shared_ptr<Screen> nextProcess(int coreId);
+    // Locks a ready queue for `coreId`, adding any time spent blocked to its lockWait
+    std::unique_lock<std::mutex> lockCounted(std::mutex& mtx, int coreId);
+    // Counts one queued process and wakes an idle core for it, trying
+    // `preferredCore` first
+    void signalWork(int preferredCore = -1);
+    // Wakes up to `count` parked cores, fewer while cores are spinning
+    void wakeIdleCores(int count, int preferredCore = -1);
+    bool wakeParkedCore(int preferredCore);
+    // Spins and/or parks per idle-strategy until work may be queued
+    void idleWait(int coreId);
+
+    // mlfq, sjf and srtf replace the per-core queues with one shared ReadyQueue
+    bool usesSharedQueue() const { return sharedQueue != nullptr; }
+    void pushShared(const std::shared_ptr<Screen>& process, ReadyQueue::Reason reason);
+    std::shared_ptr<Screen> popShared(int coreId, int& quantum);
+    // srtf: true when a queued process has less work left than `screen`
+    bool shorterJobWaiting(const std::shared_ptr<Screen>& screen);
+
+    // Scheduling strategies. With delay-per-exec 0 they run whole slices
+    // through Screen::runSlice; FCFS runs at most FCFS_BATCH per call.
+    static constexpr int FCFS_BATCH = 1024;
     void executeProcessFCFS(const std::shared_ptr<Screen>& screen, int coreId);
-    void executeProcessRR(const std::shared_ptr<Screen>& screen, int coreId);
+    void executeProcessRR(const std::shared_ptr<Screen>& screen, int coreId, int quantum);
 
     // Dummy process generation thread loop
     void dummyProcessLoop();
+    // Program and length are drawn from Random::forProcess(seed, pid)
+    std::shared_ptr<Screen> createDummyProcess();
+    ArrivalProcess makeArrivalProcess(unsigned int seed) const;
+    double requestedArrivalRate() const;
+    bool belowDummyLimit() const;
+    void beginArrivalPeriod();
+    void endArrivalPeriod();
+
+    // Virtual clock mode: one thread steps every emulated core per tick
+    // and jumps the clock to the next event when all cores are idle
+    void simulationLoop();
+    void simulateCore(int coreId, uint64_t now);
+    void simEnqueue(const std::shared_ptr<Screen>& screen, ReadyQueue::Reason reason, uint64_t now);
+    // Front of simReady, or with soft affinity a nearby process that last ran on `coreId`
+    std::shared_ptr<Screen> popSimReady(int coreId);
+
+    // Pins the calling thread when cpu-affinity is "pinned"
+    void pinThread(int coreId);
+
+    // Retunes the adaptive quantum once per interval; any thread may call,
+    // only one does the work
+    void maybeAdaptQuantum(uint64_t now);
+    bool simHasReady() const;
+
+    // SLEEP handling: park on the timer wheel, re-enqueue when due
+    void parkSleeping(const std::shared_ptr<Screen>& screen, int seconds);
+    void timerLoop();
+    uint64_t timerNow() const;
+
+    // Records a trace event; one relaxed load while tracing is off
+    void trace(TraceEvent type, const std::shared_ptr<Screen>& screen, int core, int64_t arg = 0) const {
+        if (Tracer::enabled()) Tracer::record(type, clockNow(), screen->getProcessId(), core, arg);
+    }
 
     // Utility helpers
     std::string currentTimestamp();
+    void completeProcess(const std::shared_ptr<Screen>& screen);
     void handleProcessError(const std::shared_ptr<Screen>& screen, const std::string& message);
 
     // Wait for all threads to join
@@ -56,15 +267,86 @@ private:
 
     InternalSchedulerType schedulerType;
 
-    int numCores;
+    // Cores taking work. Queues exist for the first coreSlots cores (every
+    // core ever started), so counters of removed cores stay in reports.
+    std::atomic<int> numCores;
+    std::atomic<int> coreSlots;
     int quantumCycles;
+    std::mutex resizeMutex;
 
     std::vector<std::thread> cores;
+    std::chrono::steady_clock::time_point startTime;
     std::thread dummyThread;
+    std::thread timerThread;
+    std::thread simThread;
 
-    std::mutex queueMutex;
+    // Global injection queue for newly admitted processes
+    std::mutex injectMutex;
+    std::deque<std::shared_ptr<Screen>> injectQueue;
+
+    // MAX_CORES entries, created on first use
+    std::vector<std::unique_ptr<CoreQueue>> runQueues;
+
+    // Shared ready queue (null for fcfs and rr). feedback and shortestJob
+    // point into it for policy-specific stats; waits are in clockNow() units.
+    mutable std::mutex sharedMutex;
+    std::unique_ptr<ReadyQueue> sharedQueue;
+    FeedbackQueue* feedback = nullptr;
+    RemainingWorkQueue* shortestJob = nullptr;
+    std::atomic<long long> srtfPreemptions;
+
+    // Adaptive quantum (rr with quantum-mode adaptive), else null
+    std::unique_ptr<QuantumTuner> tuner;
+    std::mutex adaptMutex;
+    std::atomic<uint64_t> lastAdapt;
+    uint64_t adaptInterval = 0;
+    std::atomic<long long> burstsEnded;
+
+    // Counters at the previous vmstat call
+    std::mutex vmstatMutex;
+    std::vector<CounterValues> vmstatLast;
+    uint64_t vmstatLastTime = 0;
+
+    // The simulation thread parks here until work is queued; worker
+    // cores park on their CoreQueue instead
+    std::mutex idleMutex;
     std::condition_variable cv;
-    std::queue<std::shared_ptr<Screen>> screenQueue;
+    std::atomic<int> queuedCount;
+    std::atomic<int> parkedCores;
+
+    IdleStrategy idleStrategy = IdleStrategy::BLOCK;
+    std::chrono::nanoseconds idleSpin;
+    std::atomic<int> spinningCores;
+    std::atomic<unsigned> wakeCursor;
+
+    // Sleeping processes, in millisecond ticks since construction
+    std::mutex timerMutex;
+    std::condition_variable timerCv;
+    TimerWheel sleepers;
+    uint64_t timerDeadline = UINT64_MAX;   // tick the timer thread sleeps until
+    std::chrono::steady_clock::time_point timerEpoch;
+
+    // Virtual clock state, owned by the simulation thread
+    struct SimCore {
+        std::shared_ptr<Screen> screen;
+        int sliceUsed = 0;
+        int quantum = 0;
+        int delayLeft = 0;
+    };
+    std::vector<SimCore> simCores;
+    std::deque<std::shared_ptr<Screen>> simReady;
+    std::atomic<uint64_t> virtualTicks;
+    std::atomic<uint64_t> skippedTicks;
+
+    std::atomic<int> dummyCounter;
+    int dummyLimit;
+    // Dummies numbered before a restore; not counted as arrivals
+    int restoredDummies = 0;
 
-    int dummyCounter;
+    // Generator wakes early from its arrival wait when stopped
+    std::mutex generatorMutex;
+    std::condition_variable generatorCv;
+    std::atomic<uint64_t> arrivalElapsed;   // clockNow() units of finished periods
+    std::atomic<uint64_t> arrivalSince;     // start of the current period, or UINT64_MAX
+    std::atomic<long long> arrivalBatches;
 };
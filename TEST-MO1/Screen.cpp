@@ -8,61 +8,156 @@
 #include <thread>
 #include <limits>
 #include "CLIUtils.h"
+#include "LogWriter.h"
+#include "LatencyHistogram.h"
+#include "Checkpoint.h"
+#include "Random.h"
 #include <unordered_map>
-
-bool scheduled = false;
+#include <algorithm>
+#include <functional>
 
 // Constructor
 Screen::Screen()
     : name("default"), instructionPointer(0),
-    status(ProcessStatus::READY), coreAssigned(-1), errorFlag(false), processId(0)
+    status(ProcessStatus::READY), coreAssigned(-1), logPath("default.log"), processId(0)
 {
     updateTimestamp();
-    instructions.clear();
+    publishState();
 }
 
 Screen::Screen(const std::string& name_, const std::vector<Instruction>& instrs, int id)
-    : name(name_), instructions(instrs), instructionPointer(0),
-    status(ProcessStatus::READY), coreAssigned(-1), errorFlag(false), processId(id)
+    : name(name_), instructionPointer(0),
+    status(ProcessStatus::READY), coreAssigned(-1),
+    logPath(name_ + ".log"), logEnabled(true), processId(id)
 {
+    loadProgram(BytecodeCompiler::compile(instrs));
     updateTimestamp();
-    logFile.open(name + ".log", std::ios::app);
-    if (!logFile.is_open()) {
-        std::cerr << "Failed to open log file for process: " << name << std::endl;
-    }
 }
 
-bool Screen::isNumber(const std::string& s) const {
-    if (s.empty()) return false;
-    for (char c : s)
-        if (!isdigit(c) && c != '-') return false;
-    return true;
+void Screen::loadProgram(Program compiled) {
+    program = std::move(compiled);
+    registers.assign(program.slotNames.size(), 0);
+    instructionPointer = 0;
+    programCounter = 0;
+    loopStack.clear();
+    publishedTotal.store(program.size(), std::memory_order_relaxed);
+    publishState();
+}
+
+void Screen::publishState() {
+    uint64_t packed = (static_cast<uint64_t>(status) << 56)
+        | (static_cast<uint64_t>(static_cast<uint16_t>(coreAssigned + 1)) << 40)
+        | (static_cast<uint64_t>(instructionPointer) & ((1ULL << 40) - 1));
+    publishedState.store(packed, std::memory_order_release);
 }
 
-int Screen::resolveValue(const std::string& token) {
-    if (isNumber(token)) return std::stoi(token);
-    if (!memory.count(token)) memory[token] = 0;
-    return memory[token];
+ScreenState Screen::loadState() const {
+    uint64_t packed = publishedState.load(std::memory_order_acquire);
+
+    ScreenState state;
+    state.status = static_cast<ProcessStatus>(packed >> 56);
+    state.coreAssigned = static_cast<int>((packed >> 40) & 0xFFFF) - 1;
+    state.instructionPointer = static_cast<size_t>(packed & ((1ULL << 40) - 1));
+    state.totalInstructions = static_cast<size_t>(publishedTotal.load(std::memory_order_relaxed));
+    return state;
 }
 
 void Screen::executeNextInstruction() {
+    std::lock_guard<std::mutex> lock(mtx);
+    step();
+}
+
+SliceResult Screen::runSlice(int maxInstructions) {
+    SliceResult result;
+    std::lock_guard<std::mutex> lock(mtx);
+
+    try {
+        while (result.executed < maxInstructions) {
+            if (status == ProcessStatus::FINISHED || instructionPointer >= program.size()) break;
+
+            size_t before = instructionPointer;
+            step();
+            result.executed += static_cast<int>(instructionPointer - before);
+
+            if (errorFlag.load(std::memory_order_relaxed)) {
+                result.error = true;
+                result.errorMessage = "Error encountered during instruction execution.";
+                break;
+            }
+            if (sleepRequest > 0) {
+                result.sleepFor = sleepRequest;
+                sleepRequest = 0;
+                break;
+            }
+            // A program with nothing left to count (e.g. an empty FOR) stops here
+            if (instructionPointer == before) break;
+        }
+    }
+    catch (const std::exception& e) {
+        result.error = true;
+        result.errorMessage = e.what();
+    }
+
+    result.finished = !result.error
+        && (status == ProcessStatus::FINISHED || instructionPointer >= program.size());
+    return result;
+}
+
+void Screen::step() {
     assignCoreIfUnassigned(4);
 
-    if (instructions.empty()) {
+    if (program.size() == 0) {
         printLog("No instructions loaded yet. Wait for scheduler.");
         std::cout << "[INFO] Process not yet scheduled. Please run 'scheduler-start'.\n";
         return;
     }
 
-    if (status == ProcessStatus::FINISHED || instructionPointer >= instructions.size()) {
+    if (status == ProcessStatus::FINISHED || instructionPointer >= program.size()) {
         status = ProcessStatus::FINISHED;
+        publishState();
         printLog("Process already finished.");
         return;
     }
 
-    const Instruction& instr = instructions[instructionPointer];
+    // Loop bookkeeping runs inline, so every call executes exactly one
+    // counted instruction
+    const CompiledInstruction* next = &ProgramGenerator::fetch(program, programCounter, name);
+    while (next->op == OpCode::FOR_BEGIN || next->op == OpCode::FOR_END) {
+        if (next->op == OpCode::FOR_BEGIN) {
+            if (next->a > 0) {
+                loopStack.push_back({ programCounter + 1, next->a });
+                ++programCounter;
+            }
+            else {
+                programCounter += next->b;
+            }
+        }
+        else if (!loopStack.empty() && --loopStack.back().remaining > 0) {
+            programCounter = loopStack.back().bodyStart;
+        }
+        else {
+            if (!loopStack.empty()) loopStack.pop_back();
+            ++programCounter;
+        }
 
-    if (instr.type == InstructionType::PRINT && !instr.args.empty()) {
+        if (!program.procedural && programCounter >= program.code.size()) {
+            instructionPointer = program.size();
+            status = ProcessStatus::FINISHED;
+            publishState();
+            printLog("Process finished execution.");
+            return;
+        }
+        next = &ProgramGenerator::fetch(program, programCounter, name);
+    }
+
+    const CompiledInstruction& instr = *next;
+    if (registers.size() != program.slotNames.size()) {
+        registers.resize(program.slotNames.size(), 0);
+    }
+    const bool logging = logEnabled;
+
+    switch (instr.op) {
+    case OpCode::PRINT: {
         auto now = std::chrono::system_clock::now();
         std::time_t tnow = std::chrono::system_clock::to_time_t(now);
         std::tm localTime{};
@@ -74,96 +169,71 @@ void Screen::executeNextInstruction() {
         char timeBuf[40];
         std::strftime(timeBuf, sizeof(timeBuf), "(%m/%d/%Y %I:%M:%S%p)", &localTime);
 
-        std::stringstream ss;
-        ss << timeBuf << " Core:" << getCoreAssigned() << " \"" << instr.args[0] << "\"";
-        std::string logEntry = ss.str();
-
-        std::ofstream logFile(name + ".log", std::ios::app);
-        if (logFile.is_open()) {
-            logFile << logEntry << "\n";
-        }
+        std::string logEntry = timeBuf;
+        logEntry += " Core:" + std::to_string(coreAssigned) + " \"" + program.strings[instr.a] + "\"";
+        LogWriter::write(logPath, std::move(logEntry));
 
         /*std::cout << logEntry << std::endl;*/
+        break;
     }
-    else if (instr.type == InstructionType::SLEEP && !instr.args.empty()) {
-        try {
-            int duration = std::stoi(instr.args[0]);
-            /*std::cout << "[INFO] Sleeping for " << duration << " second(s)..." << std::endl;*/
-            std::this_thread::sleep_for(std::chrono::seconds(duration));
+    case OpCode::SLEEP:
+        /*std::cout << "[INFO] Sleeping for " << instr.a << " second(s)..." << std::endl;*/
+        sleepRequest = instr.a;
+        break;
+
+    case OpCode::DECLARE:
+        storeVariable(instr.dst, instr.a);
+        if (logging) {
+            printLog("DECLARE " + program.slotNames[instr.dst] + " = " + std::to_string(instr.a));
         }
-        catch (...) {
-            std::cerr << "[ERROR] Invalid sleep duration: " << instr.args[0] << "\n";
-            errorFlag = true;
+        break;
+
+    case OpCode::ADD:
+    case OpCode::SUBTRACT: {
+        int op1 = (instr.flags & OPERAND_A_IMM) ? instr.a : loadVariable(instr.a);
+        int op2 = (instr.flags & OPERAND_B_IMM) ? instr.b : loadVariable(instr.b);
+        bool isAdd = instr.op == OpCode::ADD;
+
+        storeVariable(instr.dst, isAdd ? op1 + op2 : op1 - op2);
+        if (logging) {
+            printLog(std::string(isAdd ? "ADD " : "SUBTRACT ") + program.slotNames[instr.dst] + " = "
+                + std::to_string(op1) + (isAdd ? " + " : " - ") + std::to_string(op2));
         }
+        break;
     }
-    else if (instr.type == InstructionType::DECLARE && instr.args.size() == 2) {
-        const std::string& varName = instr.args[0];
-        try {
-            int value = std::stoi(instr.args[1]);
-            memory[varName] = value;
-            /*std::cout << "[INFO] DECLARE: " << varName << " = " << value << std::endl;*/
-            printLog("DECLARE " + varName + " = " + std::to_string(value));
-        }
-        catch (...) {
-            std::cerr << "[ERROR] Invalid DECLARE value: " << instr.args[1] << std::endl;
-            errorFlag = true;
-        }
-    }
-    else if (instr.type == InstructionType::ADD && instr.args.size() == 3) {
-        const std::string& var1 = instr.args[0];
-        try {
-            int op1 = resolveValue(instr.args[1]);
-            int op2 = resolveValue(instr.args[2]);
-
-            if (!memory.count(var1)) memory[var1] = 0;
-
-            int result = op1 + op2;
-
-            /*std::cout << "[INFO] ADD: " << var1 << " = " << op1 << " + " << op2
-                << " (New: " << memory[var1] << ")\n";*/
-            printLog("ADD " + var1 + " = " + std::to_string(op1) + " + " + std::to_string(op2));
-        }
-        catch (const std::exception& e) {
-            std::cerr << "[ERROR] Invalid ADD operands: " << e.what() << "\n";
-            errorFlag = true;
-        }
-    }
-    else if (instr.type == InstructionType::SUBTRACT && instr.args.size() == 3) {
-        const std::string& var1 = instr.args[0];
-        try {
-            int op1 = resolveValue(instr.args[1]);
-            int op2 = resolveValue(instr.args[2]);
-
-            if (!memory.count(var1)) memory[var1] = 0;
-
-            int result = op1 - op2;
-
-            /*std::cout << "[INFO] SUBTRACT: " << var1 << " = " << op1 << " - " << op2
-                << " (New: " << memory[var1] << ")\n";*/
-            printLog("SUBTRACT " + var1 + " = " + std::to_string(op1) + " - " + std::to_string(op2));
-        }
-        catch (const std::exception& e) {
-            std::cerr << "[ERROR] Invalid SUBTRACT operands: " << e.what() << "\n";
-            errorFlag = true;
-        }
+    case OpCode::ERROR:
+        std::cerr << program.strings[instr.a] << "\n";
+        errorFlag.store(true, std::memory_order_relaxed);
+        break;
+
+    case OpCode::NOP:
+    case OpCode::FOR_BEGIN:
+    case OpCode::FOR_END:
+        break;
     }
 
     instructionPointer++;
-    if (instructionPointer >= instructions.size()) {
+    programCounter++;
+    if (instructionPointer >= program.size()) {
         status = ProcessStatus::FINISHED;
+        // A finished procedural program needs only its seed and length
+        if (program.procedural) std::vector<CompiledInstruction>().swap(program.code);
         printLog("Process finished execution.");
     }
+    publishState();
 }
 
 void Screen::assignCoreIfUnassigned(int totalCores) {
     if (coreAssigned == -1) {
-        coreAssigned = rand() % totalCores;
+        coreAssigned = static_cast<int>(Random::local().below(static_cast<uint32_t>(totalCores)));
+        publishState();
     }
 }
 
 void Screen::advanceInstruction() {
-    if (instructionPointer < instructions.size()) {
+    if (instructionPointer < program.size()) {
         ++instructionPointer;
+        publishState();
     }
 }
 
@@ -187,8 +257,30 @@ void Screen::showScreen() {
 
             std::cout << "\nProcess Name:   " << getName() << "\n";
             std::cout << "Process ID:     " << getProcessId() << "\n";
+            std::cout << "Migrations:     " << getMigrations() << "\n";
+
+            // Scheduler clock: ns since the scheduler was created, or virtual ticks
+            const bool virtualClock = config.clockMode == "virtual";
+            ProcessTimes t = loadTimes();
+            if (t.started) {
+                std::cout << "Arrival:        " << LatencyHistogram::format(t.arrival, virtualClock) << "\n";
+                std::cout << "First Run:      " << LatencyHistogram::format(t.firstRun, virtualClock)
+                    << " (response " << LatencyHistogram::format(t.firstRun - t.arrival, virtualClock) << ")\n";
+                std::cout << "Last Dispatch:  " << LatencyHistogram::format(t.lastDispatch, virtualClock) << "\n";
+                if (t.preemptions > 0) {
+                    std::cout << "Last Preempt:   " << LatencyHistogram::format(t.lastPreempt, virtualClock) << "\n";
+                }
+                std::cout << "Dispatches:     " << t.dispatches << " (" << t.preemptions << " preempted)\n";
+                std::cout << "CPU Time:       " << LatencyHistogram::format(t.cpuTime, virtualClock) << "\n";
+                std::cout << "Ready Wait:     " << LatencyHistogram::format(t.readyWait, virtualClock) << "\n";
+                if (t.completed) {
+                    std::cout << "Completed:      " << LatencyHistogram::format(t.finish, virtualClock)
+                        << " (turnaround " << LatencyHistogram::format(t.finish - t.arrival, virtualClock) << ")\n";
+                }
+            }
             std::cout << "Logs:\n";
-            std::ifstream readLog(name + ".log");
+            LogWriter::flush();
+            std::ifstream readLog(logPath);
             bool hasLogs = false;
             if (readLog.is_open()) {
                 std::string line;
@@ -219,6 +311,7 @@ void Screen::showScreen() {
             switch (getStatus()) {
             case ProcessStatus::READY: std::cout << "\nReady!"; break;
             case ProcessStatus::RUNNING: std::cout << "\nRunning!"; break;
+            case ProcessStatus::WAITING: std::cout << "\nSleeping!"; break;
             case ProcessStatus::FINISHED: std::cout << "\nFinished!"; break;
             }
 
@@ -235,11 +328,16 @@ void Screen::showScreen() {
 }
 
 void Screen::generateDummyInstructions(const Config& config) {
+    Xoshiro256 rng = Random::forProcess(config.seed, processId);
+    generateDummyInstructions(config, rng.range(config.minIns, config.maxIns), rng);
+}
+
+void Screen::generateDummyInstructions(const Config& config, int count, Xoshiro256& rng) {
     std::lock_guard<std::mutex> lock(mtx);
 
     std::vector<std::string> variables = { "x", "y", "z", "a", "b", "c" };
     std::vector<Instruction> instrs;
-    int count = rand() % (config.maxIns - config.minIns + 1) + config.minIns;
+    instrs.reserve(count);
 
     auto generateSimpleInstruction = [&](InstructionType type) -> Instruction {
         Instruction instr;
@@ -247,16 +345,16 @@ void Screen::generateDummyInstructions(const Config& config) {
 
         switch (type) {
         case InstructionType::DECLARE: {
-            std::string var = variables[rand() % variables.size()];
-            int value = rand() % 20 + 1;
+            std::string var = variables[rng.below(static_cast<uint32_t>(variables.size()))];
+            int value = rng.below(20) + 1;
             instr.args = { var, std::to_string(value) };
             break;
         }
         case InstructionType::ADD:
         case InstructionType::SUBTRACT: {
-            std::string dest = variables[rand() % variables.size()];
-            std::string op1 = variables[rand() % variables.size()];
-            std::string op2 = variables[rand() % variables.size()];
+            std::string dest = variables[rng.below(static_cast<uint32_t>(variables.size()))];
+            std::string op1 = variables[rng.below(static_cast<uint32_t>(variables.size()))];
+            std::string op2 = variables[rng.below(static_cast<uint32_t>(variables.size()))];
             instr.args = { dest, op1, op2 };
             break;
         }
@@ -265,7 +363,7 @@ void Screen::generateDummyInstructions(const Config& config) {
             break;
         }
         case InstructionType::SLEEP: {
-            instr.args = { std::to_string(rand() % 3 + 1) };
+            instr.args = { std::to_string(rng.below(3) + 1) };
             break;
         }
         default: break;
@@ -274,23 +372,90 @@ void Screen::generateDummyInstructions(const Config& config) {
         return instr;
         };
 
-    for (int i = 0; i < count; ++i) {
-        int choice = rand() % 5;  // 04 only
-        InstructionType type = static_cast<InstructionType>(choice);
-        instrs.push_back(generateSimpleInstruction(type));
+    // FOR loops repeat 2-5 times over a body of 1-4 instructions, nested
+    // up to for-nesting-depth; bodies are not unrolled
+    std::function<Instruction(int)> generateLoop = [&](int depthLeft) -> Instruction {
+        Instruction loop;
+        loop.type = InstructionType::FOR;
+        loop.args = { std::to_string(rng.below(4) + 2) };
+
+        int bodySize = rng.below(4) + 1;
+        for (int i = 0; i < bodySize; ++i) {
+            int choice = rng.below(depthLeft > 1 ? 6 : 5);
+            loop.body.push_back(choice == 5 ? generateLoop(depthLeft - 1)
+                : generateSimpleInstruction(static_cast<InstructionType>(choice)));
+        }
+        return loop;
+    };
+
+    uint64_t generated = 0;
+    while (generated < static_cast<uint64_t>(count)) {
+        int choice = rng.below(config.forNestingDepth > 0 ? 6 : 5);
+        if (choice == 5) {
+            instrs.push_back(generateLoop(config.forNestingDepth));
+            generated += BytecodeCompiler::expandedLength({ instrs.back() });
+        }
+        else {
+            instrs.push_back(generateSimpleInstruction(static_cast<InstructionType>(choice)));
+            ++generated;
+        }
     }
 
-    instructions = instrs;
-    instructionPointer = 0;
+    // The last loop may overshoot; stop after exactly `count` instructions
+    Program compiled = BytecodeCompiler::compile(instrs);
+    compiled.length = std::min(compiled.length, static_cast<size_t>(count));
+    loadProgram(std::move(compiled));
     status = ProcessStatus::READY;
+    publishState();
 }
 
 
-void Screen::printLog(const std::string& msg) {
+void Screen::generateProceduralInstructions(uint64_t seed, int count, int forDepth) {
+    std::lock_guard<std::mutex> lock(mtx);
+    loadProgram(ProgramGenerator::makeProcedural(seed, static_cast<size_t>(count), forDepth));
+    status = ProcessStatus::READY;
+    publishState();
+}
+
+size_t Screen::memoryFootprint() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    auto heap = [](const std::string& s) { return s.capacity() > 15 ? s.capacity() + 1 : 0; };
+    return sizeof(Screen) + program.footprint() + registers.capacity() * sizeof(int)
+        + loopStack.capacity() * sizeof(LoopFrame)
+        + heap(name) + heap(creationTimestamp) + heap(logPath);
+}
+
+void Screen::attachMemory() {
     std::lock_guard<std::mutex> lock(mtx);
-    if (logFile.is_open()) {
-        logFile << "(" << creationTimestamp << ") " << msg << std::endl;
-        logFile.flush();
+    if (pageStats) return;
+    pageStats = MemoryManager::attach(processId);
+    if (!pageStats) return;
+
+    // Restored processes already hold values; new ones start at zero
+    for (size_t slot = 0; slot < registers.size(); ++slot) {
+        if (registers[slot] != 0) MemoryManager::write(processId, static_cast<uint32_t>(slot) * 4, registers[slot]);
+    }
+}
+
+void Screen::releaseMemory() {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (pageStats) MemoryManager::release(processId);
+}
+
+// Each variable slot is a 4-byte word at slot * 4 in the process's pages
+int Screen::loadVariable(int slot) {
+    if (pageStats) return MemoryManager::read(processId, static_cast<uint32_t>(slot) * 4);
+    return registers[slot];
+}
+
+void Screen::storeVariable(int slot, int value) {
+    if (pageStats) MemoryManager::write(processId, static_cast<uint32_t>(slot) * 4, value);
+    else registers[slot] = value;
+}
+
+void Screen::printLog(const std::string& msg) {
+    if (logEnabled) {
+        LogWriter::write(logPath, "(" + creationTimestamp + ") " + msg);
     }
 }
 
@@ -317,6 +482,7 @@ std::string Screen::getName() const {
 void Screen::setName(const std::string& newName) {
     std::lock_guard<std::mutex> lock(mtx);
     name = newName;
+    logPath = newName + ".log";
 }
 
 std::string Screen::getCreationTimestamp() const {
@@ -325,72 +491,82 @@ std::string Screen::getCreationTimestamp() const {
 }
 
 size_t Screen::getCurrentInstruction() const {
-    std::lock_guard<std::mutex> lock(mtx);
-    return instructionPointer + 1;
+    return loadState().instructionPointer + 1;
 }
 
 void Screen::setInstructions(const std::vector<Instruction>& instrs) {
     std::lock_guard<std::mutex> lock(mtx);
-    instructions = instrs;
-    instructionPointer = 0;
+    loadProgram(BytecodeCompiler::compile(instrs));
     scheduled = true;
     status = ProcessStatus::READY;
+    publishState();
 }
 
 void Screen::setScheduled(bool value) {
-    std::lock_guard<std::mutex> lock(mtx);
-    scheduled = value;
+    scheduled.store(value, std::memory_order_relaxed);
 }
 
 bool Screen::isScheduled() const {
-    std::lock_guard<std::mutex> lock(mtx);
-    return scheduled;
+    return scheduled.load(std::memory_order_relaxed);
 }
 
 
 
 size_t Screen::getTotalInstructions() const {
-    std::lock_guard<std::mutex> lock(mtx);
-    return instructions.size();
+    return loadState().totalInstructions;
 }
 
-void Screen::setCoreAssigned(int core) {
+bool Screen::setCoreAssigned(int core) {
     std::lock_guard<std::mutex> lock(mtx);
+    bool migrated = assignCore(core);
+    publishState();
+    return migrated;
+}
+
+bool Screen::assignCore(int core) {
+    bool migrated = core != -1 && coreAssigned != -1 && core != coreAssigned;
+    if (migrated) ++migrations;
     coreAssigned = core;
+    return migrated;
 }
 
-int Screen::getCoreAssigned() const {
+int Screen::getMigrations() const {
     std::lock_guard<std::mutex> lock(mtx);
-    return coreAssigned;
+    return migrations;
+}
+
+int Screen::getCoreAssigned() const {
+    return loadState().coreAssigned;
 }
 
 void Screen::setStatus(ProcessStatus newStatus) {
     std::lock_guard<std::mutex> lock(mtx);
     status = newStatus;
+    publishState();
 }
 
 ProcessStatus Screen::getStatus() const {
-    std::lock_guard<std::mutex> lock(mtx);
-    return status;
+    return loadState().status;
 }
 
 bool Screen::isFinished() const {
-    std::lock_guard<std::mutex> lock(mtx);
-    return status == ProcessStatus::FINISHED;
+    return loadState().status == ProcessStatus::FINISHED;
 }
 
 void Screen::setError(bool err) {
-    errorFlag = err;
+    errorFlag.store(err, std::memory_order_relaxed);
 }
 
 bool Screen::hasError() const {
-    return errorFlag;
+    return errorFlag.load(std::memory_order_relaxed);
 }
 
 void Screen::truncateInstructions(int n) {
     std::lock_guard<std::mutex> lock(mtx);
-    if (n < instructions.size()) {
-        instructions.resize(n);
+    if (n < program.size()) {
+        program.length = n;
+        publishedTotal.store(program.size(), std::memory_order_relaxed);
+        publishState();
     }
 }
 
@@ -408,6 +584,263 @@ std::string Screen::getTimestamp() const {
     return std::string(buffer);
 }
 
+int Screen::takeSleepRequest() {
+    std::lock_guard<std::mutex> lock(mtx);
+    int duration = sleepRequest;
+    sleepRequest = 0;
+    return duration;
+}
+
+void Screen::markReady(uint64_t now) {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (!arrived) {
+        times.arrival = now;
+        arrived = true;
+        publishTimes();
+    }
+    lastReady = now;
+}
+
+void Screen::markDispatched(uint64_t now) {
+    std::lock_guard<std::mutex> lock(mtx);
+    recordDispatch(now);
+}
+
+bool Screen::beginDispatch(int core, uint64_t now, uint64_t& readyWait) {
+    std::lock_guard<std::mutex> lock(mtx);
+    bool migrated = assignCore(core);
+    scheduled.store(true, std::memory_order_relaxed);
+    status = ProcessStatus::RUNNING;
+    readyWait = recordDispatch(now);
+    publishState();
+    return migrated;
+}
+
+uint64_t Screen::recordDispatch(uint64_t now) {
+    uint64_t waited = now - lastReady;
+    times.readyWait += waited;
+    if (!times.started) {
+        times.firstRun = now;
+        times.started = true;
+    }
+    times.lastDispatch = now;
+    times.running = true;
+    ++times.dispatches;
+    publishTimes();
+    return waited;
+}
+
+void Screen::markDescheduled(uint64_t now, bool preempted) {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (!times.running) return;
+    times.cpuTime += now - times.lastDispatch;
+    times.running = false;
+    if (preempted) {
+        times.lastPreempt = now;
+        ++times.preemptions;
+    }
+    publishTimes();
+}
+
+void Screen::publishTimes() {
+    publishedTimes.arrival.store(times.arrival, std::memory_order_relaxed);
+    publishedTimes.firstRun.store(times.firstRun, std::memory_order_relaxed);
+    publishedTimes.finish.store(times.finish, std::memory_order_relaxed);
+    publishedTimes.readyWait.store(times.readyWait, std::memory_order_relaxed);
+    publishedTimes.cpuTime.store(times.cpuTime, std::memory_order_relaxed);
+    publishedTimes.lastDispatch.store(times.lastDispatch, std::memory_order_relaxed);
+    publishedTimes.lastPreempt.store(times.lastPreempt, std::memory_order_relaxed);
+    publishedTimes.preemptions.store(times.preemptions, std::memory_order_relaxed);
+    publishedTimes.completed.store(times.completed, std::memory_order_relaxed);
+    // Last, so a reader that sees the dispatch also sees firstRun
+    publishedTimes.dispatches.store(times.dispatches, std::memory_order_release);
+}
+
+ProcessTimes Screen::loadTimes() const {
+    ProcessTimes copy;
+    copy.dispatches = publishedTimes.dispatches.load(std::memory_order_acquire);
+    copy.arrival = publishedTimes.arrival.load(std::memory_order_relaxed);
+    copy.firstRun = publishedTimes.firstRun.load(std::memory_order_relaxed);
+    copy.finish = publishedTimes.finish.load(std::memory_order_relaxed);
+    copy.readyWait = publishedTimes.readyWait.load(std::memory_order_relaxed);
+    copy.cpuTime = publishedTimes.cpuTime.load(std::memory_order_relaxed);
+    copy.lastDispatch = publishedTimes.lastDispatch.load(std::memory_order_relaxed);
+    copy.lastPreempt = publishedTimes.lastPreempt.load(std::memory_order_relaxed);
+    copy.preemptions = publishedTimes.preemptions.load(std::memory_order_relaxed);
+    copy.completed = publishedTimes.completed.load(std::memory_order_relaxed);
+    copy.started = copy.dispatches > 0;
+    return copy;
+}
+
+void Screen::setPriorityLevel(int level, uint64_t epoch) {
+    std::lock_guard<std::mutex> lock(mtx);
+    priorityLevel = level;
+    priorityEpoch = epoch;
+}
+
+int Screen::getPriorityLevel(uint64_t epoch) const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return priorityEpoch == epoch ? priorityLevel : 0;
+}
+
+void Screen::markFinished(uint64_t now) {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (!times.completed) {
+        if (times.running) {
+            times.cpuTime += now - times.lastDispatch;
+            times.running = false;
+        }
+        times.finish = now;
+        times.completed = true;
+        publishTimes();
+    }
+}
+
+ProcessTimes Screen::getTimes() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return times;
+}
+
 int Screen::getProcessId() const {
     return processId;
 }
+
+ProcessStatus Screen::saveCheckpoint(CheckpointWriter& out, uint64_t& runnableSince) {
+    std::lock_guard<std::mutex> lock(mtx);
+    runnableSince = status == ProcessStatus::RUNNING ? times.lastDispatch : lastReady;
+
+    out.put<int32_t>(processId);
+    out.putString(name);
+    out.putString(creationTimestamp);
+    out.putString(logPath);
+    out.put<uint8_t>(logEnabled ? 1 : 0);
+
+    out.put<uint8_t>(static_cast<uint8_t>(status));
+    out.put<int32_t>(coreAssigned);
+    out.put<int32_t>(migrations);
+    out.put<uint8_t>(errorFlag.load() ? 1 : 0);
+    out.put<int32_t>(sleepRequest);
+    out.put<int32_t>(priorityLevel);
+
+    out.put<uint64_t>(instructionPointer);
+    out.put<uint64_t>(programCounter);
+    out.put<uint64_t>(loopStack.size());
+    for (const LoopFrame& frame : loopStack) {
+        out.put<uint64_t>(frame.bodyStart);
+        out.put<int32_t>(frame.remaining);
+    }
+
+    // A procedural program is only its seed and length; its cached block
+    // is left out and regenerated on the next fetch
+    out.put<uint8_t>(program.procedural ? 1 : 0);
+    out.put<uint64_t>(program.length);
+    out.put<uint64_t>(program.seed);
+    out.put<uint64_t>(program.blockStart);
+    out.put<int32_t>(program.forDepth);
+    out.putArray(program.procedural ? std::vector<CompiledInstruction>() : program.code);
+    out.putStrings(program.strings);
+    out.putStrings(program.slotNames);
+
+    // Paged variables of a finished process have already been released
+    std::vector<int32_t> values(registers.begin(), registers.end());
+    if (pageStats && status != ProcessStatus::FINISHED) {
+        for (size_t slot = 0; slot < values.size(); ++slot) {
+            try {
+                values[slot] = loadVariable(static_cast<int>(slot));
+            }
+            catch (const std::out_of_range&) {
+                values[slot] = 0;
+            }
+        }
+    }
+    out.putArray(values);
+
+    out.put<uint64_t>(times.arrival);
+    out.put<uint64_t>(times.firstRun);
+    out.put<uint64_t>(times.finish);
+    out.put<uint64_t>(times.readyWait);
+    out.put<uint64_t>(times.cpuTime);
+    out.put<uint64_t>(times.lastDispatch);
+    out.put<uint64_t>(times.lastPreempt);
+    out.put<int32_t>(times.dispatches);
+    out.put<int32_t>(times.preemptions);
+    out.put<uint8_t>(static_cast<uint8_t>((times.started ? 1 : 0) | (times.completed ? 2 : 0)));
+    out.put<uint64_t>(lastReady);
+    out.put<uint8_t>(arrived ? 1 : 0);
+    return status;
+}
+
+std::shared_ptr<Screen> Screen::restoreCheckpoint(CheckpointReader& in) {
+    auto screen = std::make_shared<Screen>();
+    Screen& s = *screen;
+
+    s.processId = in.get<int32_t>();
+    s.name = in.getString();
+    s.creationTimestamp = in.getString();
+    s.logPath = in.getString();
+    s.logEnabled = in.get<uint8_t>() != 0;
+
+    uint8_t savedStatus = in.get<uint8_t>();
+    if (savedStatus > static_cast<uint8_t>(ProcessStatus::FINISHED)) {
+        throw std::runtime_error("Checkpoint has an invalid process status.");
+    }
+    s.status = static_cast<ProcessStatus>(savedStatus);
+    s.coreAssigned = in.get<int32_t>();
+    s.migrations = in.get<int32_t>();
+    s.errorFlag.store(in.get<uint8_t>() != 0);
+    s.sleepRequest = in.get<int32_t>();
+    s.priorityLevel = in.get<int32_t>();
+
+    s.instructionPointer = static_cast<size_t>(in.get<uint64_t>());
+    s.programCounter = static_cast<size_t>(in.get<uint64_t>());
+    uint64_t frames = in.get<uint64_t>();
+    if (frames > in.remaining()) throw std::runtime_error("Checkpoint is truncated.");
+    s.loopStack.reserve(static_cast<size_t>(frames));
+    for (uint64_t i = 0; i < frames; ++i) {
+        LoopFrame frame;
+        frame.bodyStart = static_cast<size_t>(in.get<uint64_t>());
+        frame.remaining = in.get<int32_t>();
+        s.loopStack.push_back(frame);
+    }
+
+    s.program.procedural = in.get<uint8_t>() != 0;
+    s.program.length = static_cast<size_t>(in.get<uint64_t>());
+    s.program.seed = in.get<uint64_t>();
+    s.program.blockStart = static_cast<size_t>(in.get<uint64_t>());
+    s.program.forDepth = in.get<int32_t>();
+    s.program.code = in.getArray<CompiledInstruction>();
+    s.program.strings = in.getStrings();
+    s.program.slotNames = in.getStrings();
+
+    std::vector<int32_t> values = in.getArray<int32_t>();
+    s.registers.assign(values.begin(), values.end());
+    s.registers.resize(s.program.slotNames.size(), 0);
+
+    s.times.arrival = in.get<uint64_t>();
+    s.times.firstRun = in.get<uint64_t>();
+    s.times.finish = in.get<uint64_t>();
+    s.times.readyWait = in.get<uint64_t>();
+    s.times.cpuTime = in.get<uint64_t>();
+    s.times.lastDispatch = in.get<uint64_t>();
+    s.times.lastPreempt = in.get<uint64_t>();
+    s.times.dispatches = in.get<int32_t>();
+    s.times.preemptions = in.get<int32_t>();
+    uint8_t flags = in.get<uint8_t>();
+    s.times.started = (flags & 1) != 0;
+    s.times.completed = (flags & 2) != 0;
+    s.lastReady = in.get<uint64_t>();
+    s.arrived = in.get<uint8_t>() != 0;
+
+    // The slice that was running, or the sleep in progress, ends at the
+    // checkpoint; the process is queued again as soon as it is restored
+    if (s.status == ProcessStatus::RUNNING || s.status == ProcessStatus::WAITING) {
+        s.status = ProcessStatus::READY;
+    }
+    s.times.running = false;
+    s.scheduled.store(s.times.started || s.status == ProcessStatus::FINISHED);
+
+    s.publishedTotal.store(s.program.size(), std::memory_order_relaxed);
+    s.publishState();
+    s.publishTimes();
+    return screen;
+}
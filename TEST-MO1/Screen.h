@@ -1,17 +1,25 @@
 #ifndef SCREEN_H
 #define SCREEN_H
 
+#include <cstdint>
 #include <string>
 #include <vector>
-#include <fstream>
 #include <mutex>
+#include <atomic>
 #include <unordered_map>
 #include "Config.h"
+#include "Bytecode.h"
+#include "MemoryManager.h"
+
+class CheckpointWriter;
+class CheckpointReader;
+class Xoshiro256;
 
 // Enum for process status
 enum class ProcessStatus {
     READY,
     RUNNING,
+    WAITING,
     FINISHED
 };
 
@@ -29,9 +37,45 @@ enum class InstructionType {
 };
 
 // Instruction struct
+// FOR: args[0] is the repeat count and body holds the loop's instructions
 struct Instruction {
     InstructionType type = InstructionType::INVALID;
     std::vector<std::string> args;
+    std::vector<Instruction> body;
+};
+
+// Scheduling accounting, in scheduler clock units
+// (monotonic nanoseconds, or ticks in virtual clock mode)
+struct ProcessTimes {
+    uint64_t arrival = 0;
+    uint64_t firstRun = 0;
+    uint64_t finish = 0;
+    uint64_t readyWait = 0;
+    uint64_t cpuTime = 0;        // dispatch to deschedule, summed over slices
+    uint64_t lastDispatch = 0;
+    uint64_t lastPreempt = 0;
+    int dispatches = 0;
+    int preemptions = 0;
+    bool started = false;
+    bool completed = false;
+    bool running = false;        // dispatched and not yet descheduled
+};
+
+// Outcome of Screen::runSlice
+struct SliceResult {
+    int executed = 0;
+    int sleepFor = 0;          // SLEEP duration requested, 0 if none
+    bool finished = false;
+    bool error = false;
+    std::string errorMessage;
+};
+
+// Consistent view of a process's scheduling state, readable without locks
+struct ScreenState {
+    ProcessStatus status = ProcessStatus::READY;
+    int coreAssigned = -1;
+    size_t instructionPointer = 0;
+    size_t totalInstructions = 0;
 };
 
 class Screen {
@@ -43,8 +87,18 @@ public:
     bool isScheduled() const;
 
 
+    // Draws from the process's own stream (Random::forProcess), so the
+    // same seed and process id always give the same program
     void generateDummyInstructions(const Config& config);
+    // Generates exactly `count` instructions from `rng`, no over-allocation
+    void generateDummyInstructions(const Config& config, int count, Xoshiro256& rng);
+    // Stores only seed and length; instructions are generated block by
+    // block as the instruction pointer reaches them
+    void generateProceduralInstructions(uint64_t seed, int count, int forDepth = 0);
     void executeNextInstruction();
+    // Runs up to `maxInstructions` under a single lock acquisition, stopping
+    // early on SLEEP, error or completion
+    SliceResult runSlice(int maxInstructions);
     void advanceInstruction();
     void truncateInstructions(int n);
     void showScreen();
@@ -57,8 +111,11 @@ public:
     size_t getCurrentInstruction() const;
     size_t getTotalInstructions() const;
 
-    void setCoreAssigned(int core);
+    // Returns true when the process last ran on a different core
+    bool setCoreAssigned(int core);
     int getCoreAssigned() const;
+    // Times the process was dispatched on a different core than last time
+    int getMigrations() const;
 
     void setStatus(ProcessStatus newStatus);
     ProcessStatus getStatus() const;
@@ -68,29 +125,128 @@ public:
     bool hasError() const;
 
     void printLog(const std::string& msg);
+
+    // Sleep duration requested by the last SLEEP instruction, cleared on read.
+    // The scheduler parks the process instead of blocking the core.
+    int takeSleepRequest();
+
+    // Scheduler hooks for ProcessTimes
+    void markReady(uint64_t now);
+    // Assigns the core, marks the process scheduled and RUNNING and records
+    // the dispatch, all under one lock. Returns true on a core migration;
+    // `readyWait` receives the time spent ready since markReady.
+    bool beginDispatch(int core, uint64_t now, uint64_t& readyWait);
+    void markDispatched(uint64_t now);
+    void markFinished(uint64_t now);
+    // Ends the current slice, adding it to cpuTime; `preempted` when the
+    // quantum ran out. No-op if the process is not running.
+    void markDescheduled(uint64_t now, bool preempted);
+    ProcessTimes getTimes() const;
+    // Lock-free copy of the times as of the last mark* call. Fields are
+    // read one by one, so a concurrent update may show half applied.
+    ProcessTimes loadTimes() const;
+
+    // MLFQ level, owned by the scheduler. A level set in an earlier aging
+    // epoch reads back as 0.
+    void setPriorityLevel(int level, uint64_t epoch);
+    int getPriorityLevel(uint64_t epoch) const;
+
     int getProcessId() const;
+
+    // Approximate bytes held by this process, including its program
+    size_t memoryFootprint() const;
+
+    // Lock-free read of the state last published by the owning core
+    ScreenState loadState() const;
+
+    // Moves variables into paged memory when paging is enabled
+    void attachMemory();
+    void releaseMemory();
+    // Null when paging is disabled. Set before the process is registered
+    // and never replaced, so it is safe to read without the lock.
+    const MemoryManager::PageStats* getPageStats() const { return pageStats.get(); }
     void setProcessId(int id) { processId = id; }
+
+    // Checkpoint record of the whole process: program, position, loop
+    // stack, variables, status and accounting. A restored process that was
+    // running or sleeping comes back READY. Restoring only decodes; call
+    // attachMemory() once the checkpoint's memory config is installed.
+    // Returns the saved status; `runnableSince` is the last dispatch of a
+    // running process, otherwise when it last became ready.
+    ProcessStatus saveCheckpoint(CheckpointWriter& out, uint64_t& runnableSince);
+    static std::shared_ptr<Screen> restoreCheckpoint(CheckpointReader& in);
 private:
     void updateTimestamp();
     void assignCoreIfUnassigned(int totalCores);
-    bool isNumber(const std::string& s) const;
-    int resolveValue(const std::string& token);
+    void loadProgram(Program compiled);
+    void publishState();
+    // Executes one instruction; caller holds mtx
+    void step();
+    bool assignCore(int core);
+    uint64_t recordDispatch(uint64_t now);
+    void publishTimes();
+    int loadVariable(int slot);
+    void storeVariable(int slot, int value);
 
     std::string name;
-    std::vector<Instruction> instructions;
+    Program program;
+
+    // instructionPointer counts executed instructions (what progress
+    // reports show); programCounter is the position in program.code,
+    // which differs once FOR loops repeat their bodies
     size_t instructionPointer;
+    size_t programCounter = 0;
 
-    std::unordered_map<std::string, int> memory;
+    struct LoopFrame {
+        size_t bodyStart;
+        int remaining;
+    };
+    std::vector<LoopFrame> loopStack;
+
+    // Variable values, indexed by the slots resolved in program.slotNames
+    std::vector<int> registers;
+    // Set while variables live in paged memory instead of registers
+    std::shared_ptr<MemoryManager::PageStats> pageStats;
 
     ProcessStatus status;
     int coreAssigned;
+    int migrations = 0;
 
     std::string creationTimestamp;
     mutable std::mutex mtx;
-    std::ofstream logFile;
 
-    bool errorFlag = false;
+    // Per-process log file, written through LogWriter
+    std::string logPath;
+    bool logEnabled = false;
+
+    std::atomic<bool> scheduled{ false };
+    std::atomic<bool> errorFlag{ false };
+    int sleepRequest = 0;
+
+    // status, core and instruction pointer packed into one word so readers
+    // always see a matching set: [status:8][core+1:16][ip:40]
+    std::atomic<uint64_t> publishedState{ 0 };
+    std::atomic<uint64_t> publishedTotal{ 0 };
+
+    ProcessTimes times;
+    struct PublishedTimes {
+        std::atomic<uint64_t> arrival{ 0 };
+        std::atomic<uint64_t> firstRun{ 0 };
+        std::atomic<uint64_t> finish{ 0 };
+        std::atomic<uint64_t> readyWait{ 0 };
+        std::atomic<uint64_t> cpuTime{ 0 };
+        std::atomic<uint64_t> lastDispatch{ 0 };
+        std::atomic<uint64_t> lastPreempt{ 0 };
+        std::atomic<int> dispatches{ 0 };
+        std::atomic<int> preemptions{ 0 };
+        std::atomic<bool> completed{ false };
+    } publishedTimes;
+    uint64_t lastReady = 0;
+    bool arrived = false;
     int processId = 0;
+
+    int priorityLevel = 0;
+    uint64_t priorityEpoch = 0;
 };
 
 #endif // SCREEN_H
\ No newline at end of file
@@ -0,0 +1,86 @@
+#include "TimerWheel.h"
+#include "Screen.h"
+#include <algorithm>
+
+TimerWheel::TimerWheel(uint64_t startTick)
+    : current(startTick), count(0)
+{
+}
+
+void TimerWheel::schedule(uint64_t expiryTick, const std::shared_ptr<Screen>& process) {
+    insert(Timer{ std::max(expiryTick, current + 1), process });
+    ++count;
+}
+
+// Files a timer in the lowest level whose span still contains both the
+// current tick and the deadline.
+void TimerWheel::insert(Timer timer) {
+    for (int level = 0; level < LEVELS; ++level) {
+        int shift = SLOT_BITS * (level + 1);
+        if ((timer.expiry >> shift) == (current >> shift)) {
+            size_t slot = (timer.expiry >> (SLOT_BITS * level)) & SLOT_MASK;
+            wheel[level][slot].push_back(std::move(timer));
+            return;
+        }
+    }
+    overflow.push_back(std::move(timer));
+}
+
+// Redistributes the slot of `level` that the current tick just entered
+void TimerWheel::cascade(int level) {
+    if (level >= LEVELS) {
+        std::vector<Timer> pending;
+        pending.swap(overflow);
+        for (Timer& timer : pending) insert(std::move(timer));
+        return;
+    }
+
+    size_t slot = (current >> (SLOT_BITS * level)) & SLOT_MASK;
+    if (slot == 0) cascade(level + 1);
+
+    std::vector<Timer> pending;
+    pending.swap(wheel[level][slot]);
+    for (Timer& timer : pending) insert(std::move(timer));
+}
+
+void TimerWheel::advance(uint64_t now, std::vector<std::shared_ptr<Screen>>& expired) {
+    while (current < now) {
+        if (count == 0) {
+            current = now;
+            return;
+        }
+
+        ++current;
+        size_t slot = current & SLOT_MASK;
+        if (slot == 0) cascade(1);
+
+        std::vector<Timer>& due = wheel[0][slot];
+        for (Timer& timer : due) {
+            expired.push_back(std::move(timer.process));
+        }
+        count -= due.size();
+        due.clear();
+    }
+}
+
+// A level only holds deadlines past every deadline of the levels below it,
+// and within a level a timer sits in a slot after the current tick's, so the
+// first non-empty slot found scanning upwards holds the earliest deadline
+uint64_t TimerWheel::nextExpiry() const {
+    uint64_t earliest = UINT64_MAX;
+    if (count == 0) return earliest;
+
+    for (int level = 0; level < LEVELS; ++level) {
+        size_t currentSlot = (current >> (SLOT_BITS * level)) & SLOT_MASK;
+        for (size_t slot = currentSlot + 1; slot < SLOTS; ++slot) {
+            for (const Timer& timer : wheel[level][slot]) {
+                earliest = std::min(earliest, timer.expiry);
+            }
+            if (earliest != UINT64_MAX) return earliest;
+        }
+    }
+    for (const Timer& timer : overflow) {
+        earliest = std::min(earliest, timer.expiry);
+    }
+    return earliest;
+}
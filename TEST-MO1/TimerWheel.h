@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class Screen;
+
+// Hierarchical timer wheel for parking sleeping processes.
+// Four levels of 64 slots cover 2^24 ticks; anything further out waits in an
+// overflow list. Not thread-safe: the owner serializes access.
+class TimerWheel {
+public:
+    explicit TimerWheel(uint64_t startTick = 0);
+
+    // Parks a process until `expiryTick`. Deadlines in the past fire on the next tick.
+    void schedule(uint64_t expiryTick, const std::shared_ptr<Screen>& process);
+
+    // Advances the wheel to `now`, appending every expired process to `expired`
+    void advance(uint64_t now, std::vector<std::shared_ptr<Screen>>& expired);
+
+    // Earliest pending deadline, or UINT64_MAX when the wheel is empty
+    uint64_t nextExpiry() const;
+
+    uint64_t currentTick() const { return current; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+private:
+    static constexpr int LEVELS = 4;
+    static constexpr int SLOT_BITS = 6;
+    static constexpr int SLOTS = 1 << SLOT_BITS;
+    static constexpr uint64_t SLOT_MASK = SLOTS - 1;
+
+    struct Timer {
+        uint64_t expiry;
+        std::shared_ptr<Screen> process;
+    };
+
+    void insert(Timer timer);
+    void cascade(int level);
+
+    std::vector<Timer> wheel[LEVELS][SLOTS];
+    std::vector<Timer> overflow;
+    uint64_t current;
+    size_t count;
+};
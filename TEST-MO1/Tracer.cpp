@@ -0,0 +1,339 @@
+#include "Tracer.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <thread>
+
+std::atomic<bool> Tracer::active{ false };
+
+namespace {
+
+constexpr int MAX_CORES = 128;                 // matches the num-cpu limit
+constexpr size_t RING_CAPACITY = 65536;        // records per core, power of two
+constexpr size_t SHARED_CAPACITY = 65536;
+constexpr auto DRAIN_INTERVAL = std::chrono::milliseconds(20);
+
+const char MAGIC[8] = { 'C', 'S', 'T', 'R', 'A', 'C', 'E', '1' };
+constexpr uint32_t VERSION = 1;
+constexpr uint8_t NAMES_MARKER = 0xFF;
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t virtualClock;
+};
+
+struct Record {
+    uint64_t time;
+    int64_t arg;
+    int32_t pid;
+    int16_t core;
+    uint8_t type;
+    uint8_t reserved;
+};
+static_assert(sizeof(Record) == 24, "trace records are 24 bytes on disk");
+
+// Single-producer / single-consumer ring owned by one core thread
+struct Ring {
+    std::vector<Record> slots = std::vector<Record>(RING_CAPACITY);
+    alignas(64) std::atomic<size_t> head{ 0 };
+    alignas(64) std::atomic<size_t> tail{ 0 };
+
+    bool push(const Record& record) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == RING_CAPACITY) return false;
+
+        slots[t & (RING_CAPACITY - 1)] = record;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    template <typename F>
+    void drain(F&& consume) {
+        size_t h = head.load(std::memory_order_relaxed);
+        size_t t = tail.load(std::memory_order_acquire);
+        for (; h != t; ++h) {
+            consume(slots[h & (RING_CAPACITY - 1)]);
+        }
+        head.store(t, std::memory_order_release);
+    }
+};
+
+struct State {
+    std::atomic<Ring*> rings[MAX_CORES] = {};
+    std::mutex ringAllocMutex;
+
+    std::mutex sharedMutex;
+    std::vector<Record> shared;
+
+    // Serializes start/stop
+    std::mutex controlMutex;
+    std::ofstream file;
+    std::string path;
+    std::thread writer;
+    std::mutex wakeMutex;
+    std::condition_variable wakeCv;
+    bool stopping = false;
+
+    std::atomic<unsigned long long> written{ 0 };
+    std::atomic<unsigned long long> dropped{ 0 };
+};
+
+State state;
+thread_local Ring* localRing = nullptr;
+
+// Moves every queued record to the file; `discard` throws them away instead
+void drainAll(bool discard) {
+    std::vector<Record> batch;
+    auto collect = [&batch](const Record& record) { batch.push_back(record); };
+
+    for (int i = 0; i < MAX_CORES; ++i) {
+        Ring* ring = state.rings[i].load(std::memory_order_acquire);
+        if (ring) ring->drain(collect);
+    }
+    {
+        std::lock_guard<std::mutex> lock(state.sharedMutex);
+        batch.insert(batch.end(), state.shared.begin(), state.shared.end());
+        state.shared.clear();
+    }
+
+    if (discard || batch.empty()) return;
+    state.file.write(reinterpret_cast<const char*>(batch.data()), batch.size() * sizeof(Record));
+    state.written.fetch_add(batch.size(), std::memory_order_relaxed);
+}
+
+void writerLoop() {
+    std::unique_lock<std::mutex> lock(state.wakeMutex);
+    while (!state.stopping) {
+        state.wakeCv.wait_for(lock, DRAIN_INTERVAL, [] { return state.stopping; });
+        lock.unlock();
+        drainAll(false);
+        lock.lock();
+    }
+}
+
+const char* eventName(uint8_t type) {
+    switch (static_cast<TraceEvent>(type)) {
+    case TraceEvent::DISPATCH: return "dispatch";
+    case TraceEvent::PREEMPT: return "preempt";
+    case TraceEvent::SLEEP: return "sleep";
+    case TraceEvent::WAKE: return "wake";
+    case TraceEvent::FINISH: return "finish";
+    case TraceEvent::ENQUEUE: return "enqueue";
+    case TraceEvent::STEAL: return "steal";
+    }
+    return "unknown";
+}
+
+std::string jsonEscape(const std::string& text) {
+    std::string out;
+    for (char c : text) {
+        if (c == '"' || c == '\\') out += '\\';
+        if (static_cast<unsigned char>(c) < 0x20) continue;
+        out += c;
+    }
+    return out;
+}
+
+}
+
+bool Tracer::start(const std::string& path, bool virtualClock) {
+    std::lock_guard<std::mutex> control(state.controlMutex);
+    if (active.load()) return false;
+
+    state.file.open(path, std::ios::binary | std::ios::trunc);
+    if (!state.file.is_open()) return false;
+
+    Header header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.virtualClock = virtualClock ? 1 : 0;
+    state.file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    // Events that raced with the previous stop are stale
+    drainAll(true);
+    state.path = path;
+    state.written.store(0);
+    state.dropped.store(0);
+    state.stopping = false;
+    state.writer = std::thread(writerLoop);
+    active.store(true);
+    return true;
+}
+
+Tracer::Summary Tracer::stop(const std::vector<std::pair<int, std::string>>& names) {
+    std::lock_guard<std::mutex> control(state.controlMutex);
+    Summary summary;
+    if (!active.exchange(false)) return summary;
+
+    {
+        std::lock_guard<std::mutex> lock(state.wakeMutex);
+        state.stopping = true;
+    }
+    state.wakeCv.notify_one();
+    if (state.writer.joinable()) state.writer.join();
+    drainAll(false);
+
+    Record marker{};
+    marker.type = NAMES_MARKER;
+    marker.arg = static_cast<int64_t>(names.size());
+    state.file.write(reinterpret_cast<const char*>(&marker), sizeof(marker));
+    for (const auto& entry : names) {
+        int32_t pid = entry.first;
+        uint16_t length = static_cast<uint16_t>(std::min<size_t>(entry.second.size(), UINT16_MAX));
+        state.file.write(reinterpret_cast<const char*>(&pid), sizeof(pid));
+        state.file.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        state.file.write(entry.second.data(), length);
+    }
+    state.file.close();
+
+    summary.path = state.path;
+    summary.events = state.written.load();
+    summary.dropped = state.dropped.load();
+    return summary;
+}
+
+void Tracer::bindCore(int coreId) {
+    if (coreId < 0 || coreId >= MAX_CORES) {
+        localRing = nullptr;
+        return;
+    }
+
+    Ring* ring = state.rings[coreId].load(std::memory_order_acquire);
+    if (!ring) {
+        std::lock_guard<std::mutex> lock(state.ringAllocMutex);
+        ring = state.rings[coreId].load(std::memory_order_acquire);
+        if (!ring) {
+            ring = new Ring();
+            state.rings[coreId].store(ring, std::memory_order_release);
+        }
+    }
+    localRing = ring;
+}
+
+void Tracer::record(TraceEvent type, uint64_t time, int pid, int core, int64_t arg) {
+    if (!enabled()) return;
+
+    Record record{};
+    record.time = time;
+    record.arg = arg;
+    record.pid = pid;
+    record.core = static_cast<int16_t>(core);
+    record.type = static_cast<uint8_t>(type);
+
+    if (localRing) {
+        if (!localRing->push(record)) state.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(state.sharedMutex);
+    if (state.shared.size() >= SHARED_CAPACITY) {
+        state.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    state.shared.push_back(record);
+}
+
+int Tracer::convertToJson(const std::string& tracePath, const std::string& jsonPath) {
+    std::ifstream in(tracePath, std::ios::binary);
+    if (!in.is_open()) {
+        std::cerr << "Failed to open " << tracePath << "\n";
+        return 1;
+    }
+
+    Header header{};
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!in || std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION) {
+        std::cerr << tracePath << " is not a trace file.\n";
+        return 1;
+    }
+
+    std::vector<Record> events;
+    std::map<int, std::string> names;
+    Record record{};
+    while (in.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+        if (record.type != NAMES_MARKER) {
+            events.push_back(record);
+            continue;
+        }
+        for (int64_t i = 0; i < record.arg; ++i) {
+            int32_t pid = 0;
+            uint16_t length = 0;
+            in.read(reinterpret_cast<char*>(&pid), sizeof(pid));
+            in.read(reinterpret_cast<char*>(&length), sizeof(length));
+            std::string name(length, '\0');
+            if (length > 0) in.read(&name[0], length);
+            if (!in) break;
+            names[pid] = name;
+        }
+        break;
+    }
+
+    std::ofstream out(jsonPath);
+    if (!out.is_open()) {
+        std::cerr << "Failed to open " << jsonPath << "\n";
+        return 1;
+    }
+
+    // Cores drain into the file in batches, so restore time order first
+    std::stable_sort(events.begin(), events.end(),
+        [](const Record& a, const Record& b) { return a.time < b.time; });
+
+    // Timestamps are microseconds; one virtual tick is shown as 1 us
+    const double toMicros = header.virtualClock ? 1.0 : 1e-3;
+    auto label = [&names](int pid) {
+        auto it = names.find(pid);
+        return it != names.end() ? jsonEscape(it->second) : "pid " + std::to_string(pid);
+    };
+    // tid 0 collects queue events, core i is tid i + 1
+    auto tid = [](int core) { return core < 0 ? 0 : core + 1; };
+
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\": \"" << (header.virtualClock ? "ns" : "ms") << "\", \"otherData\": {\"clock\": \""
+        << (header.virtualClock ? "virtual ticks as us" : "monotonic") << "\"}, \"traceEvents\": [\n";
+    out << "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, \"args\": {\"name\": \"Scheduler\"}}";
+    out << ",\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": 0, \"args\": {\"name\": \"Queues\"}}";
+
+    std::map<int, Record> running;   // core -> its open DISPATCH
+    int maxCore = -1;
+    for (const Record& e : events) {
+        maxCore = std::max<int>(maxCore, e.core);
+        TraceEvent type = static_cast<TraceEvent>(e.type);
+
+        // A slice runs from DISPATCH to the PREEMPT, SLEEP or FINISH on the same core
+        if (type == TraceEvent::DISPATCH) {
+            running[e.core] = e;
+            continue;
+        }
+        if (type == TraceEvent::PREEMPT || type == TraceEvent::SLEEP || type == TraceEvent::FINISH) {
+            auto open = running.find(e.core);
+            if (open != running.end() && open->second.pid == e.pid) {
+                out << ",\n{\"name\": \"" << label(e.pid) << "\", \"cat\": \"slice\", \"ph\": \"X\", \"pid\": 1, \"tid\": "
+                    << tid(e.core) << ", \"ts\": " << open->second.time * toMicros
+                    << ", \"dur\": " << (e.time - open->second.time) * toMicros
+                    << ", \"args\": {\"pid\": " << e.pid << ", \"quantum\": " << open->second.arg
+                    << ", \"end\": \"" << eventName(e.type) << "\"}}";
+                running.erase(open);
+            }
+        }
+
+        out << ",\n{\"name\": \"" << eventName(e.type) << "\", \"cat\": \"event\", \"ph\": \"i\", \"s\": \"t\", \"pid\": 1, \"tid\": "
+            << tid(e.core) << ", \"ts\": " << e.time * toMicros
+            << ", \"args\": {\"pid\": " << e.pid << ", \"process\": \"" << label(e.pid) << "\", \"arg\": " << e.arg << "}}";
+    }
+
+    for (int core = 0; core <= maxCore; ++core) {
+        out << ",\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << tid(core)
+            << ", \"args\": {\"name\": \"Core " << core << "\"}}";
+    }
+    out << "\n]}\n";
+
+    std::cout << "Wrote " << events.size() << " events to " << jsonPath << "\n";
+    return 0;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+enum class TraceEvent : uint8_t {
+    DISPATCH = 1,   // arg: quantum
+    PREEMPT,        // arg: instructions run in the slice
+    SLEEP,          // arg: requested sleep
+    WAKE,           // core: queue it returns to, -1 = global
+    FINISH,         // arg: 1 if it ended with an error
+    ENQUEUE,        // core: queue it joined, -1 = global or shared
+    STEAL           // core: thief, arg: victim core
+};
+
+// Binary scheduler event trace.
+//
+// Like LogWriter, each core thread appends fixed-size records to its own
+// lock-free single-producer ring and other threads share a locked buffer;
+// a background thread drains them to the trace file. While tracing is off
+// a call site costs one relaxed atomic load.
+//
+// File layout: a 16-byte header ("CSTRACE1", version, clock), 24-byte
+// records, then a trailer mapping process ids to names.
+class Tracer {
+public:
+    struct Summary {
+        std::string path;
+        unsigned long long events = 0;
+        unsigned long long dropped = 0;
+    };
+
+    // False if already tracing or the file cannot be created
+    static bool start(const std::string& path, bool virtualClock);
+    // Writes the remaining events and the name trailer, then closes the file
+    static Summary stop(const std::vector<std::pair<int, std::string>>& names);
+
+    static bool enabled() { return active.load(std::memory_order_relaxed); }
+
+    // Binds the calling thread to the lock-free ring of a CPU core
+    static void bindCore(int coreId);
+
+    // `time` is in scheduler clock units (ns, or virtual ticks)
+    static void record(TraceEvent type, uint64_t time, int pid, int core, int64_t arg = 0);
+
+    // Offline conversion to Chrome trace-event JSON (chrome://tracing,
+    // Perfetto). Returns a process exit code.
+    static int convertToJson(const std::string& tracePath, const std::string& jsonPath);
+
+private:
+    static std::atomic<bool> active;
+};
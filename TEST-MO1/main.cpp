@@ -2,7 +2,13 @@
 #include "ProcessManager.h"
 #include "Config.h"
 #include "CLIUtils.h"
+#include "Benchmark.h"
+#include "LogWriter.h"
+#include "MemoryManager.h"
+#include "Tracer.h"
+#include "Checkpoint.h"
 
+#include <iomanip>
 #include <iostream>
 #include <sstream>
 #include <thread>
@@ -11,6 +17,16 @@
 bool initialized = false;
 Scheduler* scheduler = nullptr;
 
+void stopTrace() {
+    std::vector<std::pair<int, std::string>> names;
+    ProcessManager::forEachProcess([&names](const std::shared_ptr<Screen>& proc) {
+        names.emplace_back(proc->getProcessId(), proc->getName());
+    });
+    Tracer::Summary summary = Tracer::stop(names);
+    std::cout << "Trace saved to " << summary.path << " (" << summary.events << " events, "
+        << summary.dropped << " dropped)\n";
+}
+
 void commandLoop() {
     std::string input;
     CLIUtils::clearScreen();
@@ -38,6 +54,7 @@ void commandLoop() {
 
             try {
                 config.loadConfig("config.txt");
+                MemoryManager::configure(config);
 
                 std::cout << "\nConfiguration Loaded:\n";
                 std::cout << "Number of CPUs: " << config.numCpu << "\n";
@@ -47,6 +64,11 @@ void commandLoop() {
                 std::cout << "Minimum Instructions: " << config.minIns << "\n";
                 std::cout << "Maximum Instructions: " << config.maxIns << "\n";
                 std::cout << "Delays per Exec: " << config.delayPerExec << "\n";
+                if (config.maxOverallMem > 0) {
+                    std::cout << "Memory: " << config.maxOverallMem << " bytes, "
+                        << config.memPerFrame << "-byte frames, " << config.memPerProc
+                        << " bytes per process (" << config.pageReplacement << ")\n";
+                }
 
                 scheduler = new Scheduler(config);
                 initialized = true;
@@ -56,6 +78,34 @@ void commandLoop() {
                 std::cerr << "Failed to initialize system: " << e.what() << "\n";
             }
         }
+        else if (cmd == "restore") {
+            std::string path;
+            iss >> path;
+
+            if (path.empty()) {
+                std::cout << "Usage: restore <file>\n";
+            }
+            else {
+                try {
+                    // A bad file is rejected before the running emulator is touched
+                    Checkpoint::Result result;
+                    Checkpoint::Image image = Checkpoint::load(path, result);
+                    if (scheduler) {
+                        scheduler->finish();
+                        delete scheduler;
+                        scheduler = nullptr;
+                    }
+                    initialized = false;
+                    scheduler = Checkpoint::install(image, result);
+                    initialized = true;
+                    std::cout << "Restored " << result.processes << " processes (" << result.queued
+                        << " queued) from " << path << " in " << std::fixed << std::setprecision(3)
+                        << result.seconds * 1000.0 << " ms. Use scheduler-start to resume.\n";
+                } catch (const std::exception& e) {
+                    std::cerr << "Failed to restore checkpoint: " << e.what() << "\n";
+                }
+            }
+        }
         else if (!initialized) {
             std::cout << "Command not available. Please run 'initialize' first.\n";
         }
@@ -123,7 +173,76 @@ void commandLoop() {
             }
         }
         else if (cmd == "report-util") {
-            ProcessManager::generateReport();
+            ProcessManager::generateReport(scheduler);
+        }
+        else if (cmd == "trace") {
+            std::string opt, path;
+            iss >> opt >> path;
+
+            if (opt == "start" && !path.empty()) {
+                if (Tracer::start(path, config.clockMode == "virtual")) {
+                    std::cout << "Tracing scheduler events to " << path << ".\n";
+                }
+                else {
+                    std::cout << (Tracer::enabled() ? "A trace is already running.\n" : "Failed to open " + path + ".\n");
+                }
+            }
+            else if (opt == "stop") {
+                if (Tracer::enabled()) stopTrace();
+                else std::cout << "No trace is running.\n";
+            }
+            else {
+                std::cout << "Usage: trace start <file> | trace stop\n";
+            }
+        }
+        else if (cmd == "checkpoint") {
+            std::string path;
+            iss >> path;
+
+            if (path.empty()) {
+                std::cout << "Usage: checkpoint <file>\n";
+            }
+            else {
+                try {
+                    Checkpoint::Result result = Checkpoint::save(path, scheduler);
+                    std::cout << "Checkpoint saved to " << path << " (" << result.processes << " processes, "
+                        << result.bytes << " bytes) in " << std::fixed << std::setprecision(3)
+                        << result.seconds * 1000.0 << " ms.\n";
+                } catch (const std::exception& e) {
+                    std::cerr << "Failed to save checkpoint: " << e.what() << "\n";
+                }
+            }
+        }
+        else if (cmd == "cpu-set") {
+            int count = 0;
+            if (!(iss >> count)) {
+                std::cout << "Usage: cpu-set <n>\n";
+            }
+            else {
+                try {
+                    int before = scheduler->coreCount();
+                    scheduler->setCoreCount(count);
+                    // screen -ls, checkpoints and benchmarks report the live count
+                    config.numCpu = count;
+                    std::cout << "Cores: " << before << " -> " << count << ".\n";
+                } catch (const std::exception& e) {
+                    std::cerr << e.what() << "\n";
+                }
+            }
+        }
+        else if (cmd == "vmstat") {
+            std::cout << "\n";
+            scheduler->printVmstat(std::cout);
+            std::cout << "\n";
+        }
+        else if (cmd == "sched-stats") {
+            std::cout << "\n";
+            scheduler->printStats(std::cout);
+            std::cout << "\n";
+            LogWriter::printStats(std::cout);
+            std::cout << "\n";
+            ProcessManager::printMemoryStats(std::cout, config);
+            std::cout << "\n";
         }
         else {
             std::cout << "Unrecognized command.\n";
@@ -131,13 +250,28 @@ void commandLoop() {
     }
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "--bench") {
+        return Benchmark::run(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--trace-json") {
+        if (argc != 4) {
+            std::cerr << "Usage: " << argv[0] << " --trace-json <trace file> <json file>\n";
+            return 2;
+        }
+        return Tracer::convertToJson(argv[2], argv[3]);
+    }
+
+    LogWriter::start();
     commandLoop();
 
     if (scheduler) {
         delete scheduler;
         scheduler = nullptr;
     }
+    if (Tracer::enabled()) stopTrace();
+    LogWriter::shutdown();
+    MemoryManager::shutdown();
 
     return 0;
 }